@@ -0,0 +1,225 @@
+/*!
+	@file MAX7219_7SEG_RPI/bench/src/main.cpp
+	@author Gavin Lyons
+	@brief Microbenchmark of the public display API for Max7219 seven segment displays
+	Runs off device against MAX7219_TransportRecorder, no hardware or bcm2835 library needed.
+	For each API and chain length 1 to 32 reports ns per call, bytes on the wire per call
+	and transactions per call, as CSV (default) or JSON.
+
+	Project Name: MAX7219_7SEG_RPI
+
+	@details
+		Each call writes to the farthest display of the chain (display = chain length) so every
+		transaction is chain length * 2 bytes. Inputs alternate between two values so the shadow
+		registers never suppress a call. InitDisplay of display 1 includes the 50mS start up delay.
+		CommitFrame writes every display of the chain in frame buffered mode then commits.
+	@note Usage: ./bin/bench [-j] [-n iterations] [-c max chain length]
+*/
+
+// Libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <chrono>
+#include <string_view>
+#include <MAX7219_7SEG_RPI.hpp>
+
+// A benchmarked API call, i is the iteration number
+typedef void (*BenchFunc_t)(MAX7219_SS_RPI &display, uint32_t i);
+
+// One benchmark
+struct Bench_t
+{
+	const char *Api;
+	BenchFunc_t Func;
+};
+
+// Function Prototypes
+void BenchDisplayTextChar(MAX7219_SS_RPI &display, uint32_t i);
+void BenchDisplayTextView(MAX7219_SS_RPI &display, uint32_t i);
+void BenchDisplayIntNum(MAX7219_SS_RPI &display, uint32_t i);
+void BenchDisplayDecNumNibble(MAX7219_SS_RPI &display, uint32_t i);
+void BenchDisplayBCDText(MAX7219_SS_RPI &display, uint32_t i);
+void BenchClearDisplay(MAX7219_SS_RPI &display, uint32_t i);
+void BenchInitDisplay(MAX7219_SS_RPI &display, uint32_t i);
+void BenchCommitFrame(MAX7219_SS_RPI &display, uint32_t i);
+void BenchDisplayTextWide(MAX7219_SS_RPI &display, uint32_t i);
+void BenchDisplayTextWideCached(MAX7219_SS_RPI &display, uint32_t i);
+bool InitChain(MAX7219_SS_RPI &display, uint8_t chainLength);
+void PrintResult(bool json, bool first, const char *api, uint8_t chainLength, uint32_t iterations,
+	double nsPerCall, double bytesPerCall, double transactionsPerCall);
+
+const Bench_t Benches[] =
+{
+	{"DisplayText(const char*)",      BenchDisplayTextChar},
+	{"DisplayText(std::string_view)", BenchDisplayTextView},
+	{"DisplayIntNum",                 BenchDisplayIntNum},
+	{"DisplayDecNumNibble",           BenchDisplayDecNumNibble},
+	{"DisplayBCDText",                BenchDisplayBCDText},
+	{"ClearDisplay",                  BenchClearDisplay},
+	{"InitDisplay",                   BenchInitDisplay},
+	{"CommitFrame",                   BenchCommitFrame},
+	{"DisplayTextWide",               BenchDisplayTextWide},
+	{"DisplayTextWide(frame cache)",  BenchDisplayTextWideCached},
+};
+
+// Main loop
+int main(int argc, char **argv)
+{
+	bool json = false;
+	uint32_t iterations = 2000;
+	uint8_t maxChain = MAX7219_MAX_DISPLAYS;
+	for (int arg = 1; arg < argc; arg++)
+	{
+		if (strcmp(argv[arg], "-j") == 0) json = true;
+		else if (strcmp(argv[arg], "-n") == 0 && arg + 1 < argc) iterations = strtoul(argv[++arg], nullptr, 10);
+		else if (strcmp(argv[arg], "-c") == 0 && arg + 1 < argc) maxChain = strtoul(argv[++arg], nullptr, 10);
+		else
+		{
+			fprintf(stderr, "Usage: %s [-j] [-n iterations] [-c max chain length]\n", argv[0]);
+			return -1;
+		}
+	}
+	if (iterations == 0) iterations = 1;
+	if (maxChain < 1 || maxChain > MAX7219_MAX_DISPLAYS) maxChain = MAX7219_MAX_DISPLAYS;
+
+	MAX7219_TransportRecorder recorder(false); // count only
+	MAX7219_SS_RPI display(&recorder);
+
+	if (json) printf("{\"library_version\": %u, \"results\": [\n", display.GetLibVersionNum());
+	else printf("api,chain_length,iterations,ns_per_call,bytes_per_call,transactions_per_call\n");
+
+	bool first = true;
+	for (uint8_t chainLength = 1; chainLength <= maxChain; chainLength++)
+	{
+		if (!InitChain(display, chainLength)) return -1;
+		for (const Bench_t &bench : Benches)
+		{
+			// InitDisplay of display 1 sleeps 50mS, keep its run short
+			const uint32_t count = (bench.Func == BenchInitDisplay && chainLength == 1 && iterations > 10) ? 10 : iterations;
+			for (uint32_t i = 0; i < 2; i++) bench.Func(display, i); // warm up
+			recorder.Clear();
+			const auto start = std::chrono::steady_clock::now();
+			for (uint32_t i = 0; i < count; i++) bench.Func(display, i);
+			const auto stop = std::chrono::steady_clock::now();
+			const double ns = std::chrono::duration<double, std::nano>(stop - start).count();
+			PrintResult(json, first, bench.Api, chainLength, count, ns / count,
+				(double)recorder.GetByteCount() / count, (double)recorder.GetTransactionCount() / count);
+			first = false;
+		}
+	}
+
+	if (json) printf("\n]}\n");
+	return 0;
+}
+// End of main
+
+// Function Space
+
+// Init every display of a chain, current display is left at the farthest display
+bool InitChain(MAX7219_SS_RPI &display, uint8_t chainLength)
+{
+	for (uint8_t number = chainLength; number >= 1; number--)
+	{
+		display.SetCurrentDisplayNumber(number);
+		if (!display.InitDisplay(display.ScanEightDigit, display.DecodeModeNone)) return false;
+	}
+	display.SetChainLength(chainLength);
+	display.SetCurrentDisplayNumber(chainLength);
+	display.SetFrameCache(0);
+	return true;
+}
+
+// Print one result as a CSV row or JSON object
+void PrintResult(bool json, bool first, const char *api, uint8_t chainLength, uint32_t iterations,
+	double nsPerCall, double bytesPerCall, double transactionsPerCall)
+{
+	if (json)
+	{
+		printf("%s  {\"api\": \"%s\", \"chain_length\": %u, \"iterations\": %u, \"ns_per_call\": %.1f, "
+			"\"bytes_per_call\": %.2f, \"transactions_per_call\": %.2f}",
+			first ? "" : ",\n", api, chainLength, iterations, nsPerCall, bytesPerCall, transactionsPerCall);
+	}else
+	{
+		printf("\"%s\",%u,%u,%.1f,%.2f,%.2f\n", api, chainLength, iterations, nsPerCall, bytesPerCall, transactionsPerCall);
+	}
+}
+
+void BenchDisplayTextChar(MAX7219_SS_RPI &display, uint32_t i)
+{
+	display.DisplayText((i & 1) ? "Hello.1.2" : "abcdefgh", display.AlignLeft);
+}
+
+void BenchDisplayTextView(MAX7219_SS_RPI &display, uint32_t i)
+{
+	using namespace std::literals;
+	display.DisplayText((i & 1) ? "Hello.1.2"sv : "abcdefgh"sv, display.AlignLeft);
+}
+
+void BenchDisplayIntNum(MAX7219_SS_RPI &display, uint32_t i)
+{
+	display.DisplayIntNum((i & 1) ? 12345678 : 87654321, display.AlignRight);
+}
+
+void BenchDisplayDecNumNibble(MAX7219_SS_RPI &display, uint32_t i)
+{
+	display.DisplayDecNumNibble((i & 1) ? 1234 : 4321, (i & 1) ? 5678 : 8765, display.AlignRight);
+}
+
+void BenchDisplayBCDText(MAX7219_SS_RPI &display, uint32_t i)
+{
+	display.DisplayBCDText((i & 1) ? "12345678" : "87654321");
+}
+
+void BenchClearDisplay(MAX7219_SS_RPI &display, uint32_t i)
+{
+	if (i & 1) display.ClearDisplay();
+	else display.DisplayText("88888888", display.AlignLeft); // give Clear something to clear, counted too
+}
+
+void BenchInitDisplay(MAX7219_SS_RPI &display, uint32_t i)
+{
+	(void)i;
+	display.InitDisplay(display.ScanEightDigit, display.DecodeModeNone);
+}
+
+void BenchCommitFrame(MAX7219_SS_RPI &display, uint32_t i)
+{
+	const uint8_t chainLength = display.GetChainLength();
+	display.SetFrameBuffered(true);
+	for (uint8_t number = 1; number <= chainLength; number++)
+	{
+		display.SetCurrentDisplayNumber(number);
+		display.DisplayIntNum((i & 1) ? 12345678 : 87654321, display.AlignRight);
+	}
+	display.CommitFrame();
+	display.SetFrameBuffered(false);
+	display.SetCurrentDisplayNumber(chainLength);
+}
+
+void BenchDisplayTextWide(MAX7219_SS_RPI &display, uint32_t i)
+{
+	using namespace std::literals;
+	// long enough to fill a chain of 32 displays
+	static const std::string_view texts[2] =
+	{
+		"abcdefgh12345678abcdefgh12345678abcdefgh12345678abcdefgh12345678abcdefgh12345678"
+		"abcdefgh12345678abcdefgh12345678abcdefgh12345678abcdefgh12345678abcdefgh12345678"
+		"abcdefgh12345678abcdefgh12345678abcdefgh12345678abcdefgh12345678abcdefgh12345678"
+		"abcdefgh12345678"sv,
+		"87654321hgfedcba87654321hgfedcba87654321hgfedcba87654321hgfedcba87654321hgfedcba"
+		"87654321hgfedcba87654321hgfedcba87654321hgfedcba87654321hgfedcba87654321hgfedcba"
+		"87654321hgfedcba87654321hgfedcba87654321hgfedcba87654321hgfedcba87654321hgfedcba"
+		"87654321hgfedcba"sv
+	};
+	display.DisplayTextWide(texts[i & 1], display.AlignLeft);
+}
+
+void BenchDisplayTextWideCached(MAX7219_SS_RPI &display, uint32_t i)
+{
+	MAX7219_FrameCache::Stats_t stats;
+	display.GetFrameCacheStats(stats);
+	if (stats.Capacity == 0) display.SetFrameCache(4); // turned off again by InitChain
+	BenchDisplayTextWide(display, i);
+}
+// EOF
@@ -71,15 +71,13 @@ int main(int argc, char **argv)
 		
 		// Write time to Display one
 		std::replace(TimeInfo.begin(), TimeInfo.end(), ':', '-'); // replace all ':' to '-'
-		const char *cstrTimeInfo = TimeInfo.c_str(); //convert timeinfo to c string
 		myMAX.SetCurrentDisplayNumber(1);
-		myMAX.DisplayText((char*)cstrTimeInfo, myMAX.AlignRight);
+		myMAX.DisplayText(TimeInfo, myMAX.AlignRight);
 		
 		// Write date to Display two
 		std::replace(DateInfo.begin(), DateInfo.end(), '-', '.'); // replace all '-' to '.'
-		const char *cstrDateInfo = DateInfo.c_str(); //convert dateinfo to c string
 		myMAX.SetCurrentDisplayNumber(2);
-		myMAX.DisplayText((char*)cstrDateInfo, myMAX.AlignRight);
+		myMAX.DisplayText(DateInfo, myMAX.AlignRight);
 
 		MAX7219_MilliSecondDelay(1000);
 	}
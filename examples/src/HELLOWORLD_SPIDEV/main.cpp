@@ -0,0 +1,72 @@
+/*!
+	@file MAX7219_7SEG_RPI/examples/src/HELLOWORLD_SPIDEV/main.cpp
+	@author Gavin Lyons
+	@brief A demo file library for Max7219 seven segment displays
+	Carries out most basic use case/test , "hello world" ~ helowrld
+	Linux spidev transport, no root or bcm2835_init needed, SPI must be enabled in raspi-config
+	
+	Project Name: MAX7219_7SEG_RPI
+	
+	@test
+		Test 0 Hello World
+*/
+
+// Libraries 
+#include <stdio.h>
+#include <MAX7219_7SEG_RPI.hpp> 
+
+// spidev setup
+const char SPI_DEVICE[] = "/dev/spidev0.0"; // spidev device node, /dev/spidev0.1 for CE1
+uint32_t SPI_SCLK_FREQ =  5000; // freq in kiloHertz
+
+// Constructor objects
+MAX7219_TransportSpidev mySpidev(SPI_DEVICE, SPI_SCLK_FREQ);
+MAX7219_SS_RPI myMAX(&mySpidev);
+
+// Function Prototypes
+bool Setup(void);
+void myTest(void);
+void EndTest(void);
+
+// Main loop
+int main(int argc, char **argv) 
+{
+	if (!Setup()) return -1;
+	myTest();
+	EndTest();
+	return 0;
+} 
+// End of main
+
+// Function Space
+
+// Setup test
+bool Setup(void)
+{
+	printf("Test Begin :: MAX7219_7SEG_RPI\r\n");
+	printf("MAX7219_7SEG Library version number :: %u\r\n", myMAX.GetLibVersionNum()); 
+	if(!myMAX.InitDisplay(myMAX.ScanEightDigit, myMAX.DecodeModeNone))
+	{
+		printf("Error 1203 :: could not open %s. Is SPI enabled??\n", SPI_DEVICE);
+		return false;
+	}
+	myMAX.ClearDisplay();
+	return true;
+}
+
+// Clean up before exit
+void EndTest(void)
+{
+	myMAX.DisplayEndOperations();
+	printf("Test End\r\n");
+}
+
+// Hello world test on MAX7219
+void myTest(void)
+{
+	char teststr1[] = "HElowrld";
+	myMAX.DisplayText(teststr1, myMAX.AlignRight);
+	MAX7219_MilliSecondDelay(5000);
+	myMAX.ClearDisplay();
+}
+// EOF
@@ -0,0 +1,98 @@
+/*!
+	@file MAX7219_7SEG_RPI/examples/src/MARQUEE/main.cpp
+	@author Gavin Lyons
+	@brief A demo file library for Max7219 seven segment displays
+	Scrolls a message across two cascaded displays with MAX7219_Marquee
+	Hardware SPI
+	
+	Project Name: MAX7219_7SEG_RPI
+	
+	@test
+		Test 1 Scroll left
+		Test 2 Scroll right
+		Test 3 Bounce
+*/
+
+// Libraries 
+#include <bcm2835.h>
+#include <stdio.h>
+#include <MAX7219_7SEG_RPI.hpp> 
+#include <MAX7219_7SEG_RPI_Marquee.hpp> 
+
+// Hardware SPI setup
+uint32_t SPI_SCLK_FREQ =  5000; // HW Spi only , freq in kiloHertz , MAX 125 Mhz MIN 30Khz
+uint8_t SPI_CEX_GPIO   =  0;     // HW Spi only which HW SPI chip enable pin to use,  0 or 1
+const uint8_t NUM_DISPLAYS = 2; // number of cascaded displays, display 1 is on the left
+
+// Constructor objects
+MAX7219_SS_RPI myMAX(SPI_SCLK_FREQ, SPI_CEX_GPIO);
+MAX7219_Marquee myMarquee(&myMAX);
+
+// Function Prototypes
+bool Setup(void);
+void myTest(MAX7219_Marquee::ScrollMode_e mode, const char *message, uint32_t cycles);
+void EndTest(void);
+
+// Main loop
+int main(int argc, char **argv) 
+{
+	if (!Setup()) return -1;
+	myTest(myMarquee.ScrollLeft, "HELLO FROM MAX7219 1.2.3", 2);
+	myTest(myMarquee.ScrollRight, "SCROLL RIGHT", 2);
+	myTest(myMarquee.ScrollBounce, "bounce", 3);
+	EndTest();
+	return 0;
+} 
+// End of main
+
+// Function Space
+
+// Setup test
+bool Setup(void)
+{
+	printf("Test Begin :: MAX7219_7SEG_RPI\r\n");
+	if(!bcm2835_init())  // Init the bcm2835 library
+	{
+		printf("Error 1201 :: bcm2835_init failed. Are you running as root??\n");
+		return false;
+	}
+	printf("MAX7219_7SEG Library version number :: %u\r\n", myMAX.GetLibVersionNum()); 
+	// every display eight digits, no decode, default brightness
+	if(!myMAX.InitChain(NUM_DISPLAYS, nullptr))
+	{
+		printf("Error 1202 :: bcm2835_spi_begin failed. Are you running as root??\n");
+		return false;
+	}
+	myMAX.SetFrameBuffered(true); // each scroll step is one batch of chain wide transactions
+	myMarquee.SetDisplays(1, NUM_DISPLAYS);
+	myMarquee.SetStepInterval(200);
+	return true;
+}
+
+// Clean up before exit
+void EndTest(void)
+{
+	for (uint8_t display = 1; display <= NUM_DISPLAYS; display++)
+	{
+		myMAX.SetCurrentDisplayNumber(display);
+		myMAX.ClearDisplay();
+	}
+	myMAX.CommitFrame();
+	myMAX.DisplayEndOperations();
+	bcm2835_close();
+	printf("Test End\r\n");
+}
+
+// Scroll a message until it has done a number of cycles
+void myTest(MAX7219_Marquee::ScrollMode_e mode, const char *message, uint32_t cycles)
+{
+	printf("%s\r\n", message);
+	myMarquee.SetMode(mode);
+	myMarquee.SetMessage(message);
+	while (myMarquee.GetCycleCount() < cycles)
+	{
+		myMarquee.Update();
+		MAX7219_MilliSecondDelay(5);
+	}
+}
+// EOF
@@ -9,26 +9,29 @@
 #pragma once
 
 // Libraries
-#include <bcm2835.h>
 #include <cstring>
-#include <cstdio> //snprintf
+#include <cstdio>
+#include <memory>
+#include <string_view>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
 #include "MAX7219_7SEG_RPI_Font.hpp"
+#include "MAX7219_7SEG_RPI_Transport.hpp"
+#include "MAX7219_7SEG_RPI_Queue.hpp"
+#include "MAX7219_7SEG_RPI_Capture.hpp"
+#include "MAX7219_7SEG_RPI_FrameCache.hpp"
 
-// GPIO abstraction
-#define MAX7219_CS_SetHigh  bcm2835_gpio_write(_MAX7219_CS_IO, HIGH)
-#define MAX7219_CS_SetLow   bcm2835_gpio_write(_MAX7219_CS_IO, LOW)
-#define MAX7219_CLK_SetHigh bcm2835_gpio_write(_MAX7219_CLK_IO, HIGH)
-#define MAX7219_CLK_SetLow  bcm2835_gpio_write(_MAX7219_CLK_IO, LOW)
-#define MAX7219_DIN_SetHigh bcm2835_gpio_write(_MAX7219_DIN_IO, HIGH)
-#define MAX7219_DIN_SetLow  bcm2835_gpio_write(_MAX7219_DIN_IO,LOW)
-
-#define MAX7219_CS_SetDigitalOutput  bcm2835_gpio_fsel(_MAX7219_CS_IO, BCM2835_GPIO_FSEL_OUTP)
-#define MAX7219_CLK_SetDigitalOutput bcm2835_gpio_fsel(_MAX7219_CLK_IO, BCM2835_GPIO_FSEL_OUTP)
-#define MAX7219_DIN_SetDigitalOutput bcm2835_gpio_fsel(_MAX7219_DIN_IO, BCM2835_GPIO_FSEL_OUTP)
-
-// Delay abstraction
-#define MAX7219_MicroSecondDelay bcm2835_delayMicroseconds
-#define MAX7219_MilliSecondDelay bcm2835_delay
+// Cascade limits
+#ifndef MAX7219_MAX_DISPLAYS
+#define MAX7219_MAX_DISPLAYS 32 /**< Maximum number of cascaded displays tracked, may be overridden at compile time */
+#endif
+#define MAX7219_NUM_REGISTERS 16 /**< Size of the MAX7219 register address map 0x00-0x0F */
+#define MAX7219_NUM_DIGITS 8 /**< Number of digit registers on a MAX7219 */
+#ifndef MAX7219_CACHE_LINE
+#define MAX7219_CACHE_LINE 64 /**< Alignment of the transmit buffers, may be overridden at compile time */
+#endif
 
 /*!
 	@brief  The main Class , used drive MAX7219 seven segment displays
@@ -36,8 +39,12 @@
 class MAX7219_SS_RPI
 {
 public:
+#ifndef MAX7219_NO_BCM2835
 	MAX7219_SS_RPI(uint8_t clock, uint8_t chipSelect ,uint8_t data);
 	MAX7219_SS_RPI(uint32_t kiloHertz, uint8_t SPICEX_PIN);
+#endif
+	MAX7219_SS_RPI(MAX7219_Transport *transport);
+	~MAX7219_SS_RPI();
 
 	/*! The decode-mode register sets BCD code B or no-decode operation for each digit */
 	enum DecodeMode_e : uint8_t
@@ -120,56 +127,216 @@ public:
 												overriding, but not altering, all controls and digit registers */
 	};
 
+	/*! Settings of one display in the cascade, see InitChain */
+	struct ChipConfig_t
+	{
+		ScanLimit_e ScanLimit;   /**< Number of digits scanned */
+		DecodeMode_e DecodeMode; /**< Code B decode of each digit */
+		uint8_t Intensity;       /**< Brightness 0x00 to 0x0F */
+	};
+
+	/*! Snapshot of the digit registers of every display in the cascade */
+	struct Frame_t
+	{
+		uint8_t Digits[MAX7219_MAX_DISPLAYS][MAX7219_NUM_DIGITS]; /**< Digit register values, [display-1][digit] */
+		uint8_t ChainLength; /**< Number of displays in the frame */
+		int64_t TimeStampNs; /**< steady clock time the frame was committed */
+	};
+
+	/*! Statistics of the asynchronous render thread, see StartAsync */
+	struct AsyncStats_t
+	{
+		uint32_t QueueDepth;    /**< Frames waiting to be sent now */
+		uint32_t QueueCapacity; /**< Frames the queue can hold */
+		uint32_t HighWater;     /**< Most frames ever waiting at once */
+		uint32_t FramesQueued;  /**< Frames accepted by CommitFrame */
+		uint32_t FramesFlushed; /**< Frames sent to the transport */
+		uint32_t FramesDropped; /**< Frames rejected because the queue was full */
+		uint32_t FramesCoalesced; /**< Latest wins mode, frames replaced by a newer frame before being sent */
+		uint32_t FramesUnchanged; /**< Latest wins mode, frames identical to the previous frame, not sent */
+		uint32_t LastLatencyUs; /**< CommitFrame to end of transfer time of last frame, uS */
+		uint32_t MaxLatencyUs;  /**< Largest latency seen, uS */
+		uint32_t MeanLatencyUs; /**< Mean latency of all flushed frames, uS */
+	};
+
+	/*! Bus counters of a display object, see GetStats */
+	struct Stats_t
+	{
+		uint64_t RegisterWrites;   /**< Register writes sent to displays, NOP padding not counted */
+		uint64_t WritesSuppressed; /**< Register writes not sent because the display already held the value */
+		uint64_t BytesSent;        /**< Bytes shifted out, including NOP padding */
+		uint64_t Transactions;     /**< Chip select windows */
+		uint64_t TransportNs;      /**< Time spent in transport calls, nS */
+	};
+
+	/*! Bus counters of one display in the cascade, see GetChipStats */
+	struct ChipStats_t
+	{
+		uint64_t RegisterWrites;   /**< Register writes sent to this display */
+		uint64_t WritesSuppressed; /**< Register writes to this display not sent, value already held */
+		uint64_t BytesSent;        /**< Bytes shifted out for this display, its register/data pair of each transaction, NOP included */
+		uint64_t Transactions;     /**< Chip select windows that reached this display */
+		uint64_t TransportNs;      /**< Share of the transport time, time of each transaction times 2 / length, nS */
+	};
+
 	bool InitDisplay(ScanLimit_e numDigits, DecodeMode_e decodeMode);
+	bool InitChain(uint8_t numChips, const ChipConfig_t *config);
 	void ClearDisplay(void);
 	void DisplayEndOperations(void);
 	void MAX7219SPIHWSettings(void);
 
+	void RefreshDisplay(void);
+	void InvalidateShadow(void);
+
 	void SetBrightness(uint8_t brightness);
 	void DisplayTestMode(bool OnOff);
 	void ShutdownMode(bool OnOff);
+	void SetBrightnessAll(uint8_t brightness);
+	void SetBrightnessChain(const uint8_t *brightness);
+	void DisplayTestModeAll(bool OnOff);
+	void ShutdownModeAll(bool OnOff);
+	void SetScanLimitAll(ScanLimit_e numDigits);
+	void SetDecodeModeAll(DecodeMode_e mode);
 
 	uint16_t GetCommDelay(void);
 	void SetCommDelay(uint16_t commDelay);
 
 	bool GetHardwareSPI(void);
+	MAX7219_Transport* GetTransport(void);
 
 	uint16_t GetLibVersionNum(void);
 
 	uint8_t GetCurrentDisplayNumber(void);
 	void SetCurrentDisplayNumber(uint8_t);
+	uint8_t GetChainLength(void);
+	uint8_t GetNumDigits(void);
+	void SetChainLength(uint8_t chainLength);
+
+	bool GetFrameBuffered(void);
+	void SetFrameBuffered(bool OnOff);
+	void CommitFrame(void);
+
+	bool StartAsync(uint16_t queueDepth);
+	bool StartAsyncLatest(uint16_t maxRefreshHz);
+	void StopAsync(void);
+	bool GetAsync(void);
+	void GetAsyncStats(AsyncStats_t &stats);
+
+	void GetStats(Stats_t &stats);
+	void GetChipStats(uint8_t displayNumber, ChipStats_t &stats);
+	void ResetStats(void);
+
+	bool StartCapture(const char *path);
+	void StopCapture(void);
+	bool GetCapture(void);
 
 	void DisplayChar(uint8_t digit, uint8_t value, DecimalPoint_e decimalPoint);
-	void DisplayText(char *text, TextAlignment_e TextAlignment);
-	void DisplayText(char *text);
+	void DisplayText(const char *text, TextAlignment_e TextAlignment);
+	void DisplayText(const char *text);
+	void DisplayText(std::string_view text, TextAlignment_e TextAlignment);
 	void DisplayIntNum(unsigned long number, TextAlignment_e TextAlignment);
 	void DisplayDecNumNibble(uint16_t  numberUpper, uint16_t numberLower, TextAlignment_e TextAlignment);
+	void DisplayFixedNum(long number, uint8_t decimalPlaces, TextAlignment_e TextAlignment);
+	void DisplayFloatNum(double number, uint8_t decimalPlaces, TextAlignment_e TextAlignment);
 	void DisplayBCDChar(uint8_t digit, CodeBFont_e value);
-	void DisplayBCDText(char *text);
+	void DisplayBCDText(const char *text);
 	void SetSegment(uint8_t digit, uint8_t segment);
 
+	uint16_t GetWideWidth(void);
+	void DisplayTextWide(std::string_view text, TextAlignment_e TextAlignment);
+	void DisplayIntNumWide(unsigned long number, TextAlignment_e TextAlignment);
+	void DisplayFixedNumWide(long number, uint8_t decimalPlaces, TextAlignment_e TextAlignment);
+	void SetFrameCache(uint16_t entries);
+	void GetFrameCacheStats(MAX7219_FrameCache::Stats_t &stats);
+
+	static uint16_t LayoutText(const char *text, size_t length, TextAlignment_e TextAlignment,
+		uint8_t *segments, uint16_t width, uint16_t &first);
+	static uint16_t FormatNumber(unsigned long magnitude, bool negative, uint8_t decimalPlaces,
+		TextAlignment_e TextAlignment, uint8_t *segments, uint16_t width);
+
 
 private:
-	const uint16_t _LibVersionNum = 140;
+	const uint16_t _LibVersionNum = 150;
+
+	/*! Frame cache key of a wide display write, see WideCacheKey */
+	struct WideKey_t
+	{
+		uint64_t Hash; /**< Hash of Bytes, 0 if the cache is off */
+		uint16_t Length; /**< Bytes in use */
+		uint8_t Bytes[4 + MAX7219_MAX_DISPLAYS*MAX7219_NUM_DIGITS*2]; /**< Layout, then at most a character and a '.' per digit */
+	};
 	
-	uint8_t _MAX7219_CS_IO;   /**<  GPIO connected to  CS on MAX7219,  SW SPI only */
-	uint8_t _MAX7219_DIN_IO;  /**<  GPIO connected to DIO on MAX7219,  SW SPI only */
-	uint8_t _MAX7219_CLK_IO;  /**<  GPIO connected to CLK on MAX7219,  SW SPI only */
+	MAX7219_Transport *_Transport = nullptr; /**< The bus used to send data to the displays */
+	std::unique_ptr<MAX7219_Transport> _OwnedTransport; /**< Transport created by the SW/HW SPI constructors */
+#ifndef MAX7219_NO_BCM2835
+	MAX7219_TransportSWSPI *_SWSPITransport = nullptr; /**< Set if _Transport is the owned SW SPI transport */
+#endif
 
-	uint16_t _CommDelay = 0; /**<  uS delay used in communications SW SPI, User adjust */
 	uint8_t _NoDigits   = 8; /**<  Number of digits in display */
 
-	uint32_t _KiloHertz = 5000;   /**< Spi freq in kiloHertz , MAX 125 Mhz MIN 30Khz */
-	uint8_t  _SPICEX_CS_IO = 0;  /**< value = X , which SPI_CE pin to use, X = 1 or 0 */
 	bool _HardwareSPI = false;  /**< Is the Hardware SPI on , true yes , false SW SPI*/
 
 	DecodeMode_e CurrentDecodeMode; /**< Enum to store current decode mode  */
 
 	uint8_t _CurrentDisplayNumber = 1; /**< Which display the user wishes to write to in a cascade of connected displays*/
 
-	void HighFreqshiftOut(uint8_t value);
+	uint8_t  _ShadowRegisters[MAX7219_MAX_DISPLAYS][MAX7219_NUM_REGISTERS] = {}; /**< Last value written to each register of each display */
+	uint16_t _ShadowValid[MAX7219_MAX_DISPLAYS] = {}; /**< Bit mask per display, bit N set = shadow of register N is known */
+
+	uint8_t _ChainLength = 1; /**< Number of displays in the cascade, used by chain wide transactions */
+	bool _FrameBuffered = false; /**< When true digit writes go to _FrameBuffer until CommitFrame is called */
+	uint8_t _FrameBuffer[MAX7219_MAX_DISPLAYS][MAX7219_NUM_DIGITS] = {}; /**< Pending digit register values for every display */
+	alignas(MAX7219_CACHE_LINE) uint8_t _TxArena[MAX7219_MAX_DISPLAYS*2] = {}; /**< Single register write transaction, all NOP between calls, see WriteDisplay */
+	alignas(MAX7219_CACHE_LINE) uint8_t _ChainTxBuffer[MAX7219_NUM_DIGITS*MAX7219_MAX_DISPLAYS*2] = {}; /**< Buffer for a batch of chain wide transactions, back to back */
+
+	Stats_t _Stats = {}; /**< Bus counters, see GetStats */
+	ChipStats_t _ChipStats[MAX7219_MAX_DISPLAYS] = {}; /**< Bus counters of each display, see GetChipStats */
+	std::unique_ptr<MAX7219_CaptureWriter> _Capture; /**< Capture file writer, null when not capturing */
+	std::unique_ptr<MAX7219_FrameCache> _FrameCache; /**< Prebuilt wide display frames, null when off, see SetFrameCache */
+	uint64_t _TransportTicks = 0; /**< Time in transport calls in counter ticks, converted to Stats_t::TransportNs by GetStats */
+	uint64_t _ChipTransportTicks[MAX7219_MAX_DISPLAYS] = {}; /**< Share of _TransportTicks of each display, see ChipStats_t::TransportNs */
+
+	MAX7219_SPSCQueue<Frame_t> _AsyncQueue; /**< Frames from CommitFrame waiting for the render thread */
+	std::thread _AsyncThread; /**< Render thread, sends queued frames to the transport */
+	std::atomic<bool> _AsyncRunning{false}; /**< true while the render thread runs */
+	std::mutex _BusMutex; /**< Guards transport and shadow registers while the render thread runs */
+	std::mutex _AsyncWakeMutex; /**< Used with _AsyncWake to sleep the render thread */
+	std::condition_variable _AsyncWake; /**< Wakes the render thread when a frame is queued */
+	std::atomic<uint32_t> _AsyncQueued{0};  /**< See AsyncStats_t */
+	std::atomic<uint32_t> _AsyncFlushed{0}; /**< See AsyncStats_t */
+	std::atomic<uint32_t> _AsyncDropped{0}; /**< See AsyncStats_t */
+	std::atomic<uint32_t> _AsyncHighWater{0}; /**< See AsyncStats_t */
+	std::atomic<uint32_t> _AsyncLastLatencyUs{0}; /**< See AsyncStats_t */
+	std::atomic<uint32_t> _AsyncMaxLatencyUs{0}; /**< See AsyncStats_t */
+	std::atomic<uint64_t> _AsyncTotalLatencyUs{0}; /**< Sum of latencies, for the mean */
+	std::atomic<uint32_t> _AsyncCoalesced{0}; /**< See AsyncStats_t */
+	std::atomic<uint32_t> _AsyncUnchanged{0}; /**< See AsyncStats_t */
+
+	bool _AsyncLatest = false; /**< true = latest wins mailbox, false = frame queue */
+	uint32_t _AsyncIntervalUs = 0; /**< Latest wins mode, minimum time between frames sent, uS */
+	std::mutex _MailboxMutex; /**< Guards _Mailbox and _MailboxFull */
+	Frame_t _Mailbox; /**< Latest wins mode, newest frame not yet sent */
+	bool _MailboxFull = false; /**< true if _Mailbox holds a frame */
+	Frame_t _LastCommitted; /**< Latest wins mode, last frame accepted by CommitFrame, to drop unchanged frames */
+	bool _LastCommittedValid = false; /**< true if _LastCommitted holds a frame */
+
 	void WriteDisplay(uint8_t RegisterCode, uint8_t data);
+	void SendRegister(uint8_t display, uint8_t RegisterCode, uint8_t data);
+	void WriteChain(uint8_t RegisterCode, const uint8_t *data);
+	void WriteChainAll(uint8_t RegisterCode, uint8_t data);
+	void PackChain(uint8_t RegisterCode, const uint8_t *data, uint8_t *buffer, uint8_t chainLength);
+	void FlushFrame(const uint8_t (*digits)[MAX7219_NUM_DIGITS], uint8_t chainLength);
+	bool StartAsyncThread(void);
+	void AsyncThreadLoop(void);
+	bool AsyncNextFrame(Frame_t &frame);
+	void SendTransaction(const uint8_t *buffer, uint16_t length);
+	void SendBatch(const uint8_t *buffer, uint16_t length, uint16_t count);
+	void CountChipTraffic(uint16_t length, uint16_t count, uint64_t ticks);
 	uint8_t ASCIIFetch(uint8_t character,DecimalPoint_e decimalPoint);
+	void WriteDigits(const uint8_t *segments, uint16_t first, uint16_t count);
+	void WriteWide(const uint8_t *segments, uint16_t first, uint16_t count, const WideKey_t &cacheKey);
+	bool WriteWideCached(const WideKey_t &cacheKey);
+	void WideCacheKey(uint8_t function, const void *content, size_t length, TextAlignment_e TextAlignment, WideKey_t &cacheKey);
 	void SetDecodeMode(DecodeMode_e mode);
 	void SetScanLimit(ScanLimit_e numDigits);
 };
@@ -0,0 +1,80 @@
+/*!
+	@file MAX7219_7SEG_RPI_Capture.hpp
+	@author Gavin Lyons
+	@brief library header file, capture file of the bus traffic sent to MAX7219 displays
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+	@details File format, all fields little endian:
+		- Header 16 bytes: "MAX7219C" magic, uint16 version (1), uint16 record size (8), uint32 reserved (0).
+		- Records 8 bytes: uint32 field, uint8 chip, uint8 register, uint8 data, uint8 flags.
+		- Transaction record, flags bit 0 set: uint32 field is uS since the previous transaction
+		  (saturates), chip is the number of register/data pairs in the transaction.
+		- Pair record, flags bit 0 clear: uint32 field is 0, chip is the display index
+		  (0 = display one, nearest the Pi), register and data are the pair sent to it.
+		  NOP pairs are not recorded, a replay fills them in.
+*/
+
+#pragma once
+
+// Libraries
+#include <stdint.h>
+#include <stdio.h>
+
+#define MAX7219_CAPTURE_VERSION 1 /**< Version of capture file format */
+#define MAX7219_CAPTURE_RECORD_SIZE 8 /**< Size of one record in bytes */
+#define MAX7219_CAPTURE_FLAG_TRANSACTION 0x01 /**< Record flags bit, record starts a transaction */
+
+/*!
+	@brief Writes transactions to a capture file through a buffer, one fwrite per 4096 records
+*/
+class MAX7219_CaptureWriter
+{
+public:
+	MAX7219_CaptureWriter() = default;
+	~MAX7219_CaptureWriter();
+	MAX7219_CaptureWriter(const MAX7219_CaptureWriter&) = delete;
+	MAX7219_CaptureWriter& operator=(const MAX7219_CaptureWriter&) = delete;
+
+	bool Open(const char *path);
+	void Close(void);
+	bool IsOpen(void);
+	void Write(const uint8_t *buffer, uint16_t length, int64_t timeNs);
+	bool Flush(void);
+	uint32_t GetTransactionCount(void);
+
+private:
+	static constexpr uint16_t BufferRecords = 4096; /**< Records buffered before each fwrite */
+
+	FILE *_File = nullptr; /**< Capture file, nullptr = closed */
+	uint8_t _Buffer[BufferRecords * MAX7219_CAPTURE_RECORD_SIZE]; /**< Records not yet written */
+	uint32_t _BufferUsed = 0; /**< Bytes used in _Buffer */
+	int64_t _LastTimeNs = 0; /**< Time of previous transaction */
+	bool _First = true; /**< true until the first transaction, its time step is 0 */
+	uint32_t _TransactionCount = 0; /**< Transactions written */
+	bool _Error = false; /**< true if an fwrite failed */
+
+	void AddRecord(uint32_t field, uint8_t chip, uint8_t reg, uint8_t data, uint8_t flags);
+};
+
+/*!
+	@brief Reads a capture file back as transactions, see MAX7219_CaptureWriter
+*/
+class MAX7219_CaptureReader
+{
+public:
+	MAX7219_CaptureReader() = default;
+	~MAX7219_CaptureReader();
+	MAX7219_CaptureReader(const MAX7219_CaptureReader&) = delete;
+	MAX7219_CaptureReader& operator=(const MAX7219_CaptureReader&) = delete;
+
+	bool Open(const char *path);
+	void Close(void);
+	bool Next(uint8_t *buffer, uint16_t bufferSize, uint16_t &length, uint32_t &deltaUs);
+
+private:
+	FILE *_File = nullptr; /**< Capture file, nullptr = closed */
+	uint8_t _Pending[MAX7219_CAPTURE_RECORD_SIZE]; /**< Transaction record read ahead by Next */
+	bool _HavePending = false; /**< true if _Pending holds the next transaction record */
+};
+
+// == EOF ==
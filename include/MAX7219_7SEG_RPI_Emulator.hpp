@@ -0,0 +1,66 @@
+/*!
+	@file MAX7219_7SEG_RPI_Emulator.hpp
+	@author Gavin Lyons
+	@brief library header file, software emulator of a daisy chain of MAX7219 chips
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#pragma once
+
+// Libraries
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "MAX7219_7SEG_RPI_Transport.hpp"
+
+/*!
+	@brief Emulates a chain of MAX7219 chips at the wire level, for testing without hardware
+	@details Each chip has a 16 bit shift register. On each CLK rising edge DIN is shifted into
+		chip 0 (display one, nearest the Pi) and the bit shifted out of each chip (DOUT) goes into
+		the next chip. On the CS (LOAD) rising edge every chip latches its shift register into the
+		addressed register. Register state follows the datasheet: Code B decode, intensity,
+		scan limit, shutdown and display test.
+		Feed it with Edge (CS/CLK/DIN levels), FeedGpioStates (states from MAX7219_GpioPortRecorder)
+		or use it as the transport of a display object, Transfer clocks each byte in bit by bit.
+*/
+class MAX7219_Emulator : public MAX7219_Transport
+{
+public:
+	MAX7219_Emulator(uint8_t chainLength);
+
+	bool Begin(void) override;
+	void End(void) override;
+	void Transfer(const uint8_t *buffer, uint16_t length) override;
+
+	void Reset(void);
+	void Edge(bool chipSelect, bool clock, bool data);
+	void FeedGpioStates(const std::vector<uint32_t> &states, uint8_t clock, uint8_t chipSelect, uint8_t data);
+
+	uint8_t GetChainLength(void);
+	uint8_t GetRegister(uint8_t chip, uint8_t reg);
+	uint16_t GetShiftRegister(uint8_t chip);
+	bool GetDout(void);
+	uint32_t GetLatchCount(void);
+	uint8_t GetSegments(uint8_t chip, uint8_t digit);
+	std::string Render(void);
+
+private:
+	/*! One MAX7219 chip */
+	struct Chip_t
+	{
+		uint16_t Shift = 0; /**< 16 bit serial shift register */
+		uint8_t Registers[16] = {}; /**< Register file, index = register address */
+	};
+
+	std::vector<Chip_t> _Chips; /**< The chain, [0] is display one */
+	bool _ChipSelect = true; /**< Last CS (LOAD) level */
+	bool _Clock = false; /**< Last CLK level */
+	uint32_t _LatchCount = 0; /**< CS rising edges seen */
+
+	void ShiftIn(bool data);
+	void Latch(void);
+	static uint8_t CodeB(uint8_t value);
+};
+
+// == EOF ==
@@ -9,7 +9,144 @@
 #pragma once 
 
 #include <stdint.h>
+#include <array>
+
+/*! ASCII Font Data Table ASCII to Seven Segment dp-abcdefg, space 0x20 to tilde 0x7E */
+inline constexpr uint8_t SevenSegASCIIFont[95] = {
+    0x00,    /*     */
+    0x30,    /*  !  */
+    0x22,    /*  "  */
+    0x3f,    /*  #  */
+    0x5b,    /*  $  */
+    0x25,    /*  %  */
+    0x31,    /*  &  */
+    0x02,    /*  '  */
+    0x4a,    /*  (  */
+    0x68,    /*  )  */
+    0x42,    /*  *  */
+    0x07,    /*  +  */
+    0x04,    /*  ,  */
+    0x01,    /*  -  */
+    0x80,    /*  .  */
+    0x25,    /*  /  */
+    0x7e,    /*  0  */
+    0x30,    /*  1  */
+    0x6d,    /*  2  */
+    0x79,    /*  3  */
+    0x33,    /*  4  */
+    0x5b,    /*  5  */
+    0x5f,    /*  6  */
+    0x70,    /*  7  */
+    0x7f,    /*  8  */
+    0x7b,    /*  9  */
+    0x48,    /*  :  */
+    0x58,    /*  ;  */
+    0x43,    /*  <  */
+    0x09,    /*  =  */
+    0x61,    /*  >  */
+    0x65,    /*  ?  */
+    0x7d,    /*  @  */
+    0x77,    /*  A  */
+    0x1f,    /*  B  */
+    0x4e,    /*  C  */
+    0x3d,    /*  D  */
+    0x4f,    /*  E  */
+    0x47,    /*  F  */
+    0x5e,    /*  G  */
+    0x37,    /*  H  */
+    0x06,    /*  I  */
+    0x3c,    /*  J  */
+    0x57,    /*  K  */
+    0x0e,    /*  L  */
+    0x54,    /*  M  */
+    0x76,    /*  N  */
+    0x7e,    /*  O  */
+    0x67,    /*  P  */
+    0x6b,    /*  Q  */
+    0x66,    /*  R  */
+    0x5b,    /*  S  */
+    0x0f,    /*  T  */
+    0x3e,    /*  U  */
+    0x3e,    /*  V  */
+    0x2a,    /*  W  */
+    0x37,    /*  X  */
+    0x3b,    /*  Y  */
+    0x6d,    /*  Z  */
+    0x4e,    /*  [  */
+    0x13,    /*  \  */
+    0x78,    /*  ]  */
+    0x62,    /*  ^  */
+    0x08,    /*  _  */
+    0x20,    /*  `  */
+    0x7d,    /*  a  */
+    0x1f,    /*  b  */
+    0x0d,    /*  c  */
+    0x3d,    /*  d  */
+    0x6f,    /*  e  */
+    0x47,    /*  f  */
+    0x7b,    /*  g  */
+    0x17,    /*  h  */
+    0x04,    /*  i  */
+    0x18,    /*  j  */
+    0x57,    /*  k  */
+    0x06,    /*  l  */
+    0x14,    /*  m  */
+    0x15,    /*  n  */
+    0x1d,    /*  o  */
+    0x67,    /*  p  */
+    0x73,    /*  q  */
+    0x05,    /*  r  */
+    0x5b,    /*  s  */
+    0x0f,    /*  t  */
+    0x1c,    /*  u  */
+    0x1c,    /*  v  */
+    0x14,    /*  w  */
+    0x37,    /*  x  */
+    0x3b,    /*  y  */
+    0x6d,    /*  z  */
+    0x4e,    /*  {  */
+    0x06,    /*  |  */
+    0x78,    /*  }  */
+    0x40     /*  ~  */
+};
 
 extern const uint8_t * pSevenSegASCIIFont;  /**<Pointer to the font table stored in the cpp file*/
 
+constexpr uint8_t  SevenSegASCIIOffset = 0x20;  /**< The font starts at ASCII 0x20 space */
+constexpr uint8_t  SevenSegDecimalPoint = 0x80; /**< Decimal point segment dp-abcdefg */
+constexpr uint16_t SevenSegLookupSize = 512;    /**< 256 characters without then with decimal point */
+
+/*!
+	@brief Build the seven segment lookup table at compile time
+	@return table, index = character for dp off, character + 256 for dp on.
+		Characters outside the font are blank (dp segment only for dp on)
+*/
+constexpr std::array<uint8_t, SevenSegLookupSize> SevenSegMakeLookup(void)
+{
+	std::array<uint8_t, SevenSegLookupSize> table{};
+	for (uint16_t character = 0; character < 256; character++)
+	{
+		uint8_t value = 0x00;
+		if (character >= SevenSegASCIIOffset && character < SevenSegASCIIOffset + sizeof(SevenSegASCIIFont))
+			value = SevenSegASCIIFont[character - SevenSegASCIIOffset];
+		table[character] = value;
+		table[character + 256] = value | SevenSegDecimalPoint;
+	}
+	return table;
+}
+
+/*! Seven segment lookup table for every 8 bit character, with decimal point variants. See SevenSegMakeLookup */
+inline constexpr std::array<uint8_t, SevenSegLookupSize> SevenSegLookup = SevenSegMakeLookup();
+
+/*!
+	@brief Fetch the seven segment code of a character, branch free
+	@param character The character to  lookup
+	@param decimalPoint 1 = set the decimal point segment, 0 = off
+	@return The seven segment representation of the character in a byte dpabcdefg
+*/
+constexpr uint8_t SevenSegFetch(uint8_t character, uint8_t decimalPoint)
+{
+	return SevenSegLookup[((decimalPoint & 0x01) << 8) | character];
+}
+
 // == EOF ==
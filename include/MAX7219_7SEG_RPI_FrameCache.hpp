@@ -0,0 +1,69 @@
+/*!
+	@file MAX7219_7SEG_RPI_FrameCache.hpp
+	@author Gavin Lyons
+	@brief library header file, cache of prebuilt frames for MAX7219 displays
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#pragma once
+
+// Libraries
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+
+/*!
+	@brief Fixed size cache of frames keyed by their content, least recently used entry evicted
+	@details All memory is allocated by the constructor, capacity * (entrySize + keySize) bytes.
+		The layout of an entry is up to the user, see MAX7219_SS_RPI::SetFrameCache.
+		Entries are found by a 64 bit hash of the key through a bucket table (a power of two, at least
+		twice the capacity) of chained entry indices, and the key bytes are compared on a hash match,
+		so two keys with the same hash never share a frame.
+*/
+class MAX7219_FrameCache
+{
+public:
+	/*! Statistics of the cache, see GetStats */
+	struct Stats_t
+	{
+		uint32_t Hits;      /**< Lookups that found their frame */
+		uint32_t Misses;    /**< Lookups that did not */
+		uint32_t Evictions; /**< Entries replaced by a newer frame */
+		uint32_t Collisions; /**< Hash matches with a different key, counted as misses */
+		uint16_t Entries;   /**< Entries in use */
+		uint16_t Capacity;  /**< Entries the cache can hold */
+	};
+
+	MAX7219_FrameCache(uint16_t capacity, uint16_t entrySize, uint16_t keySize);
+
+	int32_t Find(uint64_t hash, const void *key, size_t length);
+	int32_t Insert(uint64_t hash, const void *key, size_t length);
+	uint8_t *GetEntry(int32_t index);
+	void Clear(void);
+	void GetStats(Stats_t &stats);
+
+	static uint64_t Hash(const void *data, size_t length, uint64_t hash = HashSeed);
+
+	static constexpr uint64_t HashSeed = 0xCBF29CE484222325ULL; /**< FNV-1a 64 bit offset basis */
+
+private:
+	uint16_t _Capacity; /**< Number of entries */
+	uint16_t _EntrySize; /**< Bytes per entry */
+	uint16_t _KeySize; /**< Largest key in bytes */
+	uint16_t _Entries = 0; /**< Entries in use, slots 0 to _Entries-1 */
+	uint64_t _UseCount = 0; /**< Incremented on every use, stamps _LastUse */
+	std::vector<uint64_t> _Hashes; /**< Key hash of each entry */
+	std::vector<uint16_t> _KeyLengths; /**< Key length of each entry */
+	std::vector<uint8_t> _KeyStorage; /**< Key bytes of each entry, _KeySize apart */
+	std::vector<uint64_t> _LastUse; /**< _UseCount when each entry was last used, smallest is evicted */
+	std::vector<uint8_t> _Storage; /**< Entries back to back */
+	std::vector<int32_t> _Buckets; /**< First entry of each bucket, -1 if empty */
+	std::vector<int32_t> _Next; /**< Next entry in the same bucket, -1 at the end */
+	uint32_t _BucketMask = 0; /**< Number of buckets - 1, bucket of a hash is hash & _BucketMask */
+	Stats_t _Stats = {}; /**< See GetStats */
+
+	void Unlink(uint16_t slot);
+};
+
+// == EOF ==
@@ -0,0 +1,69 @@
+/*!
+	@file MAX7219_7SEG_RPI_Marquee.hpp
+	@author Gavin Lyons
+	@brief library header file, scrolls text across one or more MAX7219 displays
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#pragma once
+
+// Libraries
+#include <stdint.h>
+#include <vector>
+#include <string_view>
+#include "MAX7219_7SEG_RPI.hpp"
+
+/*!
+	@brief Scrolling text, the message is converted to seven segment codes once by SetMessage,
+		each step slides a window over them
+	@details The window spans displayCount cascaded displays starting at firstDisplay,
+		firstDisplay is the left hand display. Only digits that change are sent (shadow registers),
+		in frame buffered mode each step is sent with CommitFrame.
+*/
+class MAX7219_Marquee
+{
+public:
+	/*! Direction of scrolling */
+	enum ScrollMode_e : uint8_t
+	{
+		ScrollLeft   = 0, /**< Text enters on the right and leaves on the left */
+		ScrollRight  = 1, /**< Text enters on the left and leaves on the right */
+		ScrollBounce = 2  /**< Text moves back and forth between left and right alignment */
+	};
+
+	MAX7219_Marquee(MAX7219_SS_RPI *display);
+
+	void SetMessage(std::string_view text);
+	void SetDisplays(uint8_t firstDisplay, uint8_t displayCount);
+	void SetMode(ScrollMode_e mode);
+	ScrollMode_e GetMode(void);
+	void SetStepInterval(uint32_t intervalMs);
+	uint32_t GetStepInterval(void);
+
+	void Reset(void);
+	void Step(void);
+	void Draw(void);
+	bool Update(void);
+	bool Update(uint64_t nowMs);
+
+	uint32_t GetCycleCount(void);
+	uint16_t GetWindowWidth(void);
+
+private:
+	MAX7219_SS_RPI *_Display = nullptr; /**< Display object of the chain */
+	std::vector<uint8_t> _Segments; /**< Seven segment codes of the message */
+	uint8_t _FirstDisplay = 1; /**< Left hand display of the window */
+	uint8_t _DisplayCount = 1; /**< Number of displays in the window */
+	ScrollMode_e _Mode = ScrollLeft; /**< Scroll direction */
+	uint32_t _StepIntervalMs = 250; /**< Time between steps for Update */
+	int32_t _Position = 0; /**< Index in _Segments of the left hand digit of the window, may be outside */
+	int8_t _Direction = -1; /**< Bounce mode, +1 or -1 */
+	uint64_t _LastStepMs = 0; /**< Time of last step by Update */
+	bool _Started = false; /**< false until first Update */
+	uint32_t _CycleCount = 0; /**< Completed scroll cycles */
+
+	uint8_t SegmentAt(int32_t index);
+};
+
+// == EOF ==
@@ -0,0 +1,74 @@
+/*!
+	@file MAX7219_7SEG_RPI_MultiBus.hpp
+	@author Gavin Lyons
+	@brief library header file, drives several independent chains of MAX7219 displays in parallel
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#pragma once
+
+// Libraries
+#include <stdint.h>
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "MAX7219_7SEG_RPI.hpp"
+
+#define MAX7219_MAX_CHAINS 8 /**< Maximum number of chains in a MAX7219_MultiBus */
+
+/*!
+	@brief Coordinator for several chains of displays, each on its own bus with its own worker thread
+	@details Each chain is a MAX7219_SS_RPI in frame buffered mode with its own transport
+		(SPI0 CE0, SPI0 CE1, aux SPI1, spidev, software SPI ...). CommitAll commits the frame of every
+		chain at the same time so the update takes as long as the slowest chain, not the sum of all chains.
+		Chains sharing one peripheral (SPI0 CE0 and CE1) are serialised by their transport.
+*/
+class MAX7219_MultiBus
+{
+public:
+	MAX7219_MultiBus() = default;
+	~MAX7219_MultiBus();
+
+	int8_t AddChain(MAX7219_SS_RPI *display);
+	uint8_t GetChainCount(void);
+	MAX7219_SS_RPI* GetChain(uint8_t index);
+
+	bool Start(void);
+	void Stop(void);
+	bool GetRunning(void);
+
+	void Dispatch(void);
+	void Wait(void);
+	void CommitAll(void);
+
+	int64_t GetLastCommitNs(void);
+	int64_t GetChainCommitNs(uint8_t index);
+
+private:
+	/*! One chain and the worker thread that commits it */
+	struct Worker_t
+	{
+		MAX7219_SS_RPI *Display = nullptr; /**< The chain */
+		std::thread Thread; /**< Worker thread */
+		int64_t CommitNs = 0; /**< Duration of last commit of this chain */
+	};
+
+	Worker_t _Workers[MAX7219_MAX_CHAINS]; /**< Chains added with AddChain */
+	uint8_t _ChainCount = 0; /**< Number of chains added */
+
+	std::atomic<bool> _Running{false}; /**< true while worker threads run, read without _Mutex by GetRunning */
+	uint32_t _Generation = 0; /**< Incremented by Dispatch, workers commit once per generation */
+	uint8_t _Pending = 0; /**< Workers still committing the current generation */
+	bool _Dispatched = false; /**< true between Dispatch and Wait */
+	int64_t _DispatchNs = 0; /**< Steady clock time of last Dispatch */
+	int64_t _LastCommitNs = 0; /**< Wall clock duration of last Dispatch to Wait */
+	std::mutex _Mutex; /**< Guards the members above */
+	std::condition_variable _WorkCV; /**< Wakes workers on Dispatch and Stop */
+	std::condition_variable _DoneCV; /**< Wakes Wait when the last worker finishes */
+
+	void WorkerLoop(uint8_t index);
+};
+
+// == EOF ==
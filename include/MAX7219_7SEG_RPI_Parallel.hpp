@@ -0,0 +1,144 @@
+/*!
+	@file MAX7219_7SEG_RPI_Parallel.hpp
+	@author Gavin Lyons
+	@brief library header file, bit sliced software SPI driving several chains on a shared clock
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#pragma once
+
+// Libraries
+#include <stdint.h>
+#include <vector>
+#include "MAX7219_7SEG_RPI_Transport.hpp"
+
+#define MAX7219_MAX_LANES 26 /**< Maximum number of DIN pins (chains) of a MAX7219_ParallelSWSPI */
+
+/*!
+	@brief Interface for a 32 bit GPIO port written with set and clear masks
+*/
+class MAX7219_GpioPort
+{
+public:
+	virtual ~MAX7219_GpioPort() = default;
+
+	/*!
+		@brief Make GPIO outputs
+		@param outputMask bit mask of GPIO 0-31 to make outputs
+		@return true if successful
+	*/
+	virtual bool Begin(uint32_t outputMask) = 0;
+	/*! @brief Set GPIO high @param mask bit mask of GPIO */
+	virtual void Set(uint32_t mask) = 0;
+	/*! @brief Set GPIO low @param mask bit mask of GPIO */
+	virtual void Clear(uint32_t mask) = 0;
+	/*! @brief Hold the GPIO levels written last before the next write, default no hold */
+	virtual void Hold(void) {}
+};
+
+#ifndef MAX7219_NO_BCM2835
+/*!
+	@brief GPIO port writing the GPSET0/GPCLR0 registers with bcm2835 library
+*/
+class MAX7219_GpioPortBCM2835 : public MAX7219_GpioPort
+{
+public:
+	bool Begin(uint32_t outputMask) override;
+	void Set(uint32_t mask) override;
+	void Clear(uint32_t mask) override;
+	void Hold(void) override;
+
+private:
+	volatile uint32_t *_GpioSet = nullptr; /**< GPSET0 register */
+	volatile uint32_t *_GpioClr = nullptr; /**< GPCLR0 register */
+	volatile uint32_t *_GpioLev = nullptr; /**< GPLEV0 register, read to hold each edge */
+};
+#endif
+
+/*!
+	@brief In memory GPIO port, records the state of all 32 GPIO after every write
+	@details Needs no hardware, used to check the waveforms of the parallel software SPI.
+*/
+class MAX7219_GpioPortRecorder : public MAX7219_GpioPort
+{
+public:
+	bool Begin(uint32_t outputMask) override;
+	void Set(uint32_t mask) override;
+	void Clear(uint32_t mask) override;
+	void Hold(void) override;
+
+	void ResetRecord(void);
+	const std::vector<uint32_t>& GetStates(void);
+	const std::vector<size_t>& GetHolds(void);
+	void Decode(uint8_t clock, uint8_t chipSelect, uint8_t data,
+		std::vector<uint8_t> &bytes, std::vector<uint16_t> &lengths);
+
+private:
+	uint32_t _State = 0; /**< Current state of the GPIO */
+	std::vector<uint32_t> _States; /**< State after every write */
+	std::vector<size_t> _Holds; /**< Number of recorded states at every hold */
+};
+
+class MAX7219_ParallelSWSPI;
+
+/*!
+	@brief Transport of one chain of a MAX7219_ParallelSWSPI, queues transactions until Flush
+*/
+class MAX7219_ParallelLane : public MAX7219_Transport
+{
+public:
+	bool Begin(void) override;
+	void End(void) override;
+	void Transfer(const uint8_t *buffer, uint16_t length) override;
+
+private:
+	friend class MAX7219_ParallelSWSPI;
+
+	MAX7219_ParallelSWSPI *_Owner = nullptr; /**< Parallel bus this lane belongs to */
+	std::vector<uint8_t> _Bytes; /**< Queued transactions back to back */
+	std::vector<uint16_t> _Lengths; /**< Length of each queued transaction */
+};
+
+/*!
+	@brief Software SPI driving up to MAX7219_MAX_LANES chains at once, one shared CLK and CS and one DIN per chain
+	@details Each chain is a display object using the transport returned by GetLane.
+		Writes are queued per lane, Flush transposes the queued transactions into one GPIO set mask
+		and one clear mask per clock edge, so all chains are clocked in the time of one.
+		Transaction i of every lane is sent in the same chip select window. Shorter transactions
+		are padded with leading NOP bytes (which shift out past the end of the chain) and lanes with
+		fewer transactions are sent NOP only transactions. All GPIO must be in bank 0 (GPIO 0-31).
+		The edges are held as in the single chain MAX7219_TransportSWSPI register path:
+		GpioPort Hold after CS low and after the DIN writes, and after each CLK edge at CommDelay 0.
+*/
+class MAX7219_ParallelSWSPI
+{
+public:
+	MAX7219_ParallelSWSPI(MAX7219_GpioPort *port, uint8_t clock, uint8_t chipSelect,
+		const uint8_t *dataPins, uint8_t laneCount);
+
+	bool Begin(void);
+	void End(void);
+
+	uint8_t GetLaneCount(void);
+	MAX7219_Transport* GetLane(uint8_t lane);
+	void Flush(void);
+
+	uint16_t GetCommDelay(void);
+	void SetCommDelay(uint16_t commDelay);
+
+private:
+	MAX7219_GpioPort *_Port = nullptr; /**< GPIO port the bus is written with */
+	uint32_t _CLKMask = 0; /**< Bit mask of shared CLK GPIO */
+	uint32_t _CSMask = 0; /**< Bit mask of shared CS GPIO */
+	uint32_t _DINMasks[MAX7219_MAX_LANES] = {}; /**< Bit mask of DIN GPIO of each lane */
+	uint32_t _AllDINMask = 0; /**< Bit mask of all DIN GPIO */
+	uint8_t _LaneCount = 0; /**< Number of lanes, 0 if pins are not valid */
+	MAX7219_ParallelLane _Lanes[MAX7219_MAX_LANES]; /**< Lane transports */
+	bool _Begun = false; /**< true after Begin */
+	uint16_t _CommDelay = 0; /**< uS delay after each clock edge, User adjust */
+
+	void SendByteColumn(const uint32_t (&bitMasks)[8]);
+};
+
+// == EOF ==
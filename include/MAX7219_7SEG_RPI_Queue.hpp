@@ -0,0 +1,86 @@
+/*!
+	@file MAX7219_7SEG_RPI_Queue.hpp
+	@author Gavin Lyons
+	@brief library header file, lock free single producer single consumer queue
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#pragma once
+
+// Libraries
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+
+/*!
+	@brief Lock free ring buffer, one thread pushes and one other thread pops
+	@details Slots are allocated once by Reset, Push and Pop never allocate.
+*/
+template <typename T>
+class MAX7219_SPSCQueue
+{
+public:
+	/*!
+		@brief Allocate the ring, not thread safe, call before producer and consumer start
+		@param capacity number of items the queue can hold
+	*/
+	void Reset(uint32_t capacity)
+	{
+		_Slots.assign(capacity + 1, T{}); // one slot always empty to tell full from empty
+		_Head.store(0, std::memory_order_relaxed);
+		_Tail.store(0, std::memory_order_relaxed);
+	}
+
+	/*!
+		@brief Copy an item into the queue, producer thread only
+		@param item the item to add
+		@return false if the queue is full
+	*/
+	bool Push(const T &item)
+	{
+		const uint32_t tail = _Tail.load(std::memory_order_relaxed);
+		const uint32_t next = Next(tail);
+		if (next == _Head.load(std::memory_order_acquire)) return false;
+		_Slots[tail] = item;
+		_Tail.store(next, std::memory_order_release);
+		return true;
+	}
+
+	/*!
+		@brief Copy the oldest item out of the queue, consumer thread only
+		@param item destination for the item
+		@return false if the queue is empty
+	*/
+	bool Pop(T &item)
+	{
+		const uint32_t head = _Head.load(std::memory_order_relaxed);
+		if (head == _Tail.load(std::memory_order_acquire)) return false;
+		item = _Slots[head];
+		_Head.store(Next(head), std::memory_order_release);
+		return true;
+	}
+
+	/*! @brief Number of items in the queue, approximate while the other thread is active @return count */
+	uint32_t Size(void) const
+	{
+		const uint32_t head = _Head.load(std::memory_order_acquire);
+		const uint32_t tail = _Tail.load(std::memory_order_acquire);
+		return (tail >= head) ? (tail - head) : (uint32_t)(_Slots.size() - head + tail);
+	}
+
+	/*! @brief Number of items the queue can hold @return capacity */
+	uint32_t Capacity(void) const {return _Slots.empty() ? 0 : (uint32_t)_Slots.size() - 1;}
+
+	/*! @brief true if the queue holds no items @return empty */
+	bool Empty(void) const {return _Head.load(std::memory_order_acquire) == _Tail.load(std::memory_order_acquire);}
+
+private:
+	std::vector<T> _Slots; /**< Ring storage, capacity + 1 slots */
+	alignas(64) std::atomic<uint32_t> _Head{0}; /**< Next slot to pop, written by consumer */
+	alignas(64) std::atomic<uint32_t> _Tail{0}; /**< Next slot to push, written by producer */
+
+	uint32_t Next(uint32_t index) const {return (index + 1 == _Slots.size()) ? 0 : index + 1;}
+};
+
+// == EOF ==
@@ -0,0 +1,79 @@
+/*!
+	@file MAX7219_7SEG_RPI_Scheduler.hpp
+	@author Gavin Lyons
+	@brief library header file, timerfd based scheduler for display effects
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#pragma once
+
+// Libraries
+#include <stdint.h>
+#include <vector>
+#include <functional>
+#include <atomic>
+#include "MAX7219_7SEG_RPI.hpp"
+#include "MAX7219_7SEG_RPI_Marquee.hpp"
+
+/*!
+	@brief Runs periodic display tasks (blink, fade, scroll, counters) off absolute monotonic deadlines
+	@details All tasks share one timerfd armed for the earliest deadline, so any number of tasks and
+		chains cost one wakeup per tick. GetFd can be added to an application's poll/epoll loop,
+		call Dispatch when it is readable. Or call Run to let the scheduler wait itself.
+		Deadlines advance by the period from the previous deadline so tasks do not drift, and are
+		multiples of the period from a common epoch so tasks with related periods share wakeups.
+		Tasks run on the thread calling Dispatch.
+*/
+class MAX7219_Scheduler
+{
+public:
+	/*! Task callback, return false to remove the task */
+	typedef std::function<bool(void)> Task_t;
+
+	MAX7219_Scheduler() = default;
+	~MAX7219_Scheduler();
+
+	bool Begin(void);
+	void End(void);
+	int GetFd(void);
+
+	int16_t AddTask(uint32_t periodMs, Task_t task);
+	bool RemoveTask(int16_t id);
+	uint16_t GetTaskCount(void);
+
+	uint16_t Dispatch(void);
+	void Run(uint32_t durationMs);
+	void Stop(void);
+
+	int16_t AddBlink(MAX7219_SS_RPI *display, uint8_t displayNumber, uint32_t periodMs);
+	int16_t AddFade(MAX7219_SS_RPI *display, uint8_t displayNumber, uint32_t periodMs);
+	int16_t AddMarquee(MAX7219_Marquee *marquee);
+	int16_t AddCounter(MAX7219_SS_RPI *display, uint8_t displayNumber, uint32_t periodMs,
+		long start, long step);
+
+	static int64_t NowNs(void);
+	static void SleepUntilNs(int64_t deadlineNs);
+
+private:
+	/*! One periodic task */
+	struct Entry_t
+	{
+		int16_t Id; /**< Id returned by AddTask */
+		int64_t PeriodNs; /**< Period */
+		int64_t DeadlineNs; /**< Next time to run, CLOCK_MONOTONIC */
+		Task_t Task; /**< Callback */
+		bool Removed; /**< Removed while dispatching, erased at the end of Dispatch */
+	};
+
+	int _TimerFd = -1; /**< timerfd, -1 = not begun */
+	std::vector<Entry_t> _Tasks; /**< Scheduled tasks */
+	int16_t _NextId = 0; /**< Id of next task added */
+	int64_t _EpochNs = 0; /**< Deadlines are multiples of their period from this time, set by first AddTask */
+	bool _Dispatching = false; /**< true while Dispatch runs tasks */
+	std::atomic<bool> _Stop{false}; /**< Set by Stop to end Run */
+
+	void Arm(void);
+};
+
+// == EOF ==
@@ -0,0 +1,226 @@
+/*!
+	@file MAX7219_7SEG_RPI_Transport.hpp
+	@author Gavin Lyons
+	@brief library header file, bus transports used to send data to MAX7219 displays
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#pragma once
+
+// Libraries
+#include <stdint.h>
+#include <vector>
+#include <mutex>
+
+#ifndef MAX7219_NO_BCM2835
+#include <bcm2835.h>
+
+// GPIO abstraction
+#define MAX7219_CS_SetHigh  bcm2835_gpio_write(_MAX7219_CS_IO, HIGH)
+#define MAX7219_CS_SetLow   bcm2835_gpio_write(_MAX7219_CS_IO, LOW)
+#define MAX7219_CLK_SetHigh bcm2835_gpio_write(_MAX7219_CLK_IO, HIGH)
+#define MAX7219_CLK_SetLow  bcm2835_gpio_write(_MAX7219_CLK_IO, LOW)
+#define MAX7219_DIN_SetHigh bcm2835_gpio_write(_MAX7219_DIN_IO, HIGH)
+#define MAX7219_DIN_SetLow  bcm2835_gpio_write(_MAX7219_DIN_IO,LOW)
+
+#define MAX7219_CS_SetDigitalOutput  bcm2835_gpio_fsel(_MAX7219_CS_IO, BCM2835_GPIO_FSEL_OUTP)
+#define MAX7219_CLK_SetDigitalOutput bcm2835_gpio_fsel(_MAX7219_CLK_IO, BCM2835_GPIO_FSEL_OUTP)
+#define MAX7219_DIN_SetDigitalOutput bcm2835_gpio_fsel(_MAX7219_DIN_IO, BCM2835_GPIO_FSEL_OUTP)
+
+// Delay abstraction
+#define MAX7219_MicroSecondDelay bcm2835_delayMicroseconds
+#define MAX7219_MilliSecondDelay bcm2835_delay
+
+#ifndef MAX7219_GPIO_EDGE_READS
+#define MAX7219_GPIO_EDGE_READS 1 /**< GPLEV0 reads after each software SPI edge, may be overridden at compile time */
+#endif
+
+/*!
+	@brief Hold a GPIO edge written with GPSET0/GPCLR0 before the next write
+	@param gpioLev GPLEV0 register
+	@details The GPIO block answers a read only after the writes posted ahead of it, so when this
+		returns the edge is on the pin and has been for MAX7219_GPIO_EDGE_READS read round trips.
+		Used after every DIN and CLK write of the register level software SPI paths, for the
+		MAX7219 data setup (tDS 25nS) and clock high and low times (tCH, tCL 50nS).
+*/
+inline void MAX7219_GpioEdgeHold(volatile uint32_t *gpioLev)
+{
+	for (uint8_t read = 0; read < MAX7219_GPIO_EDGE_READS; read++) (void)bcm2835_peri_read_nb(gpioLev);
+}
+#else
+// Delay abstraction, off device build without bcm2835 library
+void MAX7219_DelayMicroseconds(uint64_t micros);
+void MAX7219_DelayMilliseconds(unsigned int millis);
+#define MAX7219_MicroSecondDelay MAX7219_DelayMicroseconds
+#define MAX7219_MilliSecondDelay MAX7219_DelayMilliseconds
+#endif
+
+/*!
+	@brief Interface for the bus used to send data to a chain of MAX7219 displays
+	@details A transaction is a group of bytes sent inside one chip select window.
+*/
+class MAX7219_Transport
+{
+public:
+	virtual ~MAX7219_Transport() = default;
+
+	/*! @brief Start the bus  @return true if successful */
+	virtual bool Begin(void) = 0;
+	/*! @brief End bus operations */
+	virtual void End(void) = 0;
+	/*! @brief (Re)apply bus settings, for buses shared with other devices */
+	virtual void RefreshSettings(void) {}
+	/*!
+		@brief Send one transaction
+		@param buffer the bytes to send
+		@param length number of bytes in buffer
+	*/
+	virtual void Transfer(const uint8_t *buffer, uint16_t length) = 0;
+	virtual void TransferBatch(const uint8_t *buffer, uint16_t length, uint16_t count);
+};
+
+#ifndef MAX7219_NO_BCM2835
+/*!
+	@brief Software SPI transport, bit bangs three GPIO with bcm2835 library
+	@details When all three GPIO are in bank 0 (GPIO 0-31) the bits are written straight to the
+		GPSET0/GPCLR0 registers with precomputed masks, without delay calls if CommDelay is 0.
+		Each edge is then held by MAX7219_GpioEdgeHold. CommDelay 0 is the safe minimum as long as
+		one GPLEV0 read takes 50nS or more; on a board where a scope shows shorter CLK pulses raise
+		MAX7219_GPIO_EDGE_READS or use CommDelay 1, which holds each CLK level 1uS.
+*/
+class MAX7219_TransportSWSPI : public MAX7219_Transport
+{
+public:
+	MAX7219_TransportSWSPI(uint8_t clock, uint8_t chipSelect, uint8_t data);
+
+	bool Begin(void) override;
+	void End(void) override;
+	void Transfer(const uint8_t *buffer, uint16_t length) override;
+
+	uint16_t GetCommDelay(void);
+	void SetCommDelay(uint16_t commDelay);
+
+private:
+	uint8_t _MAX7219_CS_IO;   /**<  GPIO connected to  CS on MAX7219 */
+	uint8_t _MAX7219_DIN_IO;  /**<  GPIO connected to DIO on MAX7219 */
+	uint8_t _MAX7219_CLK_IO;  /**<  GPIO connected to CLK on MAX7219 */
+	uint16_t _CommDelay = 0; /**<  uS delay used in communications, User adjust */
+
+	volatile uint32_t *_GpioSet = nullptr; /**< GPSET0 register, null if fast path not usable */
+	volatile uint32_t *_GpioClr = nullptr; /**< GPCLR0 register */
+	volatile uint32_t *_GpioLev = nullptr; /**< GPLEV0 register, read to hold each edge */
+	uint32_t _CSMask  = 0; /**< GPSET0/GPCLR0 bit mask of CS GPIO */
+	uint32_t _CLKMask = 0; /**< GPSET0/GPCLR0 bit mask of CLK GPIO */
+	uint32_t _DINMask = 0; /**< GPSET0/GPCLR0 bit mask of DIN GPIO */
+
+	void HighFreqshiftOut(uint8_t value);
+	void FastTransfer(const uint8_t *buffer, uint16_t length);
+	void FastTransferDelay(const uint8_t *buffer, uint16_t length);
+};
+
+/*!
+	@brief Hardware SPI transport, SPI0 with bcm2835 library
+	@details Transfers from several instances (e.g. CE0 and CE1 chains on different threads)
+		are serialised and each instance re-applies its settings if another one used SPI0 last.
+*/
+class MAX7219_TransportHWSPI : public MAX7219_Transport
+{
+public:
+	MAX7219_TransportHWSPI(uint32_t kiloHertz, uint8_t SPICEX_PIN);
+
+	bool Begin(void) override;
+	void End(void) override;
+	void RefreshSettings(void) override;
+	void Transfer(const uint8_t *buffer, uint16_t length) override;
+	void TransferBatch(const uint8_t *buffer, uint16_t length, uint16_t count) override;
+
+private:
+	uint32_t _KiloHertz = 5000;   /**< Spi freq in kiloHertz , MAX 125 Mhz MIN 30Khz */
+	uint8_t  _SPICEX_CS_IO = 0;  /**< value = X , which SPI_CE pin to use, X = 1 or 0 */
+	bool _SPI0Begun = false; /**< true between Begin and End of this transport */
+
+	static std::mutex _SPI0Mutex; /**< SPI0 is one peripheral shared by all CE0/CE1 transports */
+	static const MAX7219_TransportHWSPI *_SPI0Owner; /**< Transport whose settings SPI0 holds */
+	static uint8_t _SPI0Users; /**< Transports begun and not yet ended, SPI0 ends at zero */
+
+	void ApplySettings(void);
+};
+
+/*!
+	@brief Auxiliary hardware SPI transport, SPI1 with bcm2835 library
+	@details SPI1 is a separate peripheral from SPI0 so a chain on it does not share bus time
+		or settings with SPI0 devices. Pins GPIO20 (MOSI), GPIO21 (SCLK), GPIO16 (CE2), mode 0 MSB first.
+*/
+class MAX7219_TransportAuxSPI : public MAX7219_Transport
+{
+public:
+	MAX7219_TransportAuxSPI(uint32_t kiloHertz);
+
+	bool Begin(void) override;
+	void End(void) override;
+	void RefreshSettings(void) override;
+	void Transfer(const uint8_t *buffer, uint16_t length) override;
+	void TransferBatch(const uint8_t *buffer, uint16_t length, uint16_t count) override;
+
+private:
+	uint32_t _KiloHertz = 5000; /**< Spi freq in kiloHertz */
+};
+#endif
+
+/*!
+	@brief Linux spidev transport, /dev/spidevX.Y
+	@details Needs no root access or bcm2835 library. TransferBatch queues all transactions
+		as separate chip select windows in one SPI_IOC_MESSAGE ioctl call.
+*/
+class MAX7219_TransportSpidev : public MAX7219_Transport
+{
+public:
+	MAX7219_TransportSpidev(const char *device, uint32_t kiloHertz);
+	~MAX7219_TransportSpidev();
+
+	bool Begin(void) override;
+	void End(void) override;
+	void Transfer(const uint8_t *buffer, uint16_t length) override;
+	void TransferBatch(const uint8_t *buffer, uint16_t length, uint16_t count) override;
+
+	uint32_t GetErrorCount(void);
+
+private:
+	static constexpr uint16_t MaxTransfersPerMessage = 256; /**< Max transfers in one ioctl, kernel limit is 511 */
+	static constexpr uint32_t MaxBytesPerMessage = 4096; /**< spidev default bufsiz module parameter */
+
+	char _Device[32] = {}; /**< Path of spidev device node */
+	uint32_t _KiloHertz = 5000; /**< Spi freq in kiloHertz */
+	int _FileDescriptor = -1; /**< Open spidev device, -1 = closed */
+	uint32_t _ErrorCount = 0; /**< Number of failed ioctl transfers */
+};
+
+/*!
+	@brief In memory transport, records every transaction instead of sending it
+	@details Needs no hardware, used for testing and profiling the library on any Linux host.
+*/
+class MAX7219_TransportRecorder : public MAX7219_Transport
+{
+public:
+	MAX7219_TransportRecorder(bool keepData = true);
+
+	bool Begin(void) override;
+	void End(void) override;
+	void Transfer(const uint8_t *buffer, uint16_t length) override;
+
+	void Clear(void);
+	uint32_t GetTransactionCount(void);
+	uint32_t GetByteCount(void);
+	const std::vector<uint8_t>& GetBytes(void);
+	const std::vector<uint16_t>& GetTransactionLengths(void);
+
+private:
+	bool _KeepData = true; /**< Store the bytes of each transaction, false only counts them */
+	uint32_t _TransactionCount = 0; /**< Transactions since last Clear */
+	uint32_t _ByteCount = 0; /**< Bytes since last Clear */
+	std::vector<uint8_t> _Bytes; /**< Bytes of every transaction back to back */
+	std::vector<uint16_t> _TransactionLengths; /**< Length of each transaction in _Bytes */
+};
+
+// == EOF ==
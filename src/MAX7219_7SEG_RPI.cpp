@@ -6,9 +6,85 @@
 	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
 */
 #include "MAX7219_7SEG_RPI.hpp"
+#include <climits>
+#include <chrono>
+#include <time.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*!
+	@brief Monotonic clock in nanoseconds
+	@return nanoseconds since an arbitrary start
+*/
+static int64_t InstrumentNowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*!
+	@brief Cheap tick counter for the transport time counter, converted to nS by InstrumentTickNs
+	@return ticks since an arbitrary start
+	@details Reading the counter on every transaction must cost much less than the transaction.
+		clock_gettime costs 40-60nS per call, the ARMv8 virtual counter and x86 TSC a few nS.
+		Other targets (e.g. 32 bit ARMv6/v7) fall back to clock_gettime.
+*/
+static inline uint64_t InstrumentTicks(void)
+{
+#if defined(__aarch64__)
+	uint64_t ticks;
+	asm volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+	return ticks;
+#elif defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return (uint64_t)InstrumentNowNs();
+#endif
+}
+
+#if defined(__x86_64__) || defined(__i386__)
+static const int64_t InstrumentStartNs = InstrumentNowNs(); /**< Monotonic time at program start, for TSC rate */
+static const uint64_t InstrumentStartTicks = InstrumentTicks(); /**< TSC at program start, for TSC rate */
+#endif
+
+/*!
+	@brief Length of one InstrumentTicks tick
+	@return nanoseconds per tick
+	@note x86 TSC rate is measured once, against the monotonic clock since program start, on the
+		first call and cached. If that call comes less than 10mS after program start it sleeps
+		the rest of the 10mS once so the measurement is long enough.
+*/
+static double InstrumentTickNs(void)
+{
+#if defined(__aarch64__)
+	static const double tickNs = []
+	{
+		uint64_t frequency;
+		asm volatile("mrs %0, cntfrq_el0" : "=r"(frequency));
+		return 1e9 / (double)frequency;
+	}();
+	return tickNs;
+#elif defined(__x86_64__) || defined(__i386__)
+	static const double tickNs = []
+	{
+		const int64_t earlyNs = InstrumentNowNs() - InstrumentStartNs;
+		if (earlyNs < 10000000) std::this_thread::sleep_for(std::chrono::nanoseconds(10000000 - earlyNs));
+		const uint64_t ticks = InstrumentTicks() - InstrumentStartTicks;
+		const int64_t elapsedNs = InstrumentNowNs() - InstrumentStartNs;
+		return (double)elapsedNs / (double)ticks;
+	}();
+	return tickNs;
+#else
+	return 1.0;
+#endif
+}
 
 // Public methods
 
+#ifndef MAX7219_NO_BCM2835
+
 /*!
 	@brief Constructor for class MAX7219_SS_RPI software SPI
 	@param clock CLk pin
@@ -18,9 +94,9 @@
 */
 MAX7219_SS_RPI::MAX7219_SS_RPI(uint8_t clock, uint8_t chipSelect , uint8_t data)
 {
-	_MAX7219_CLK_IO = clock;
-	_MAX7219_CS_IO  = chipSelect;
-	_MAX7219_DIN_IO = data;
+	_SWSPITransport = new MAX7219_TransportSWSPI(clock, chipSelect, data);
+	_OwnedTransport.reset(_SWSPITransport);
+	_Transport = _SWSPITransport;
 	_HardwareSPI = false;
 }
 
@@ -32,10 +108,31 @@ MAX7219_SS_RPI::MAX7219_SS_RPI(uint8_t clock, uint8_t chipSelect , uint8_t data)
 */
 MAX7219_SS_RPI::MAX7219_SS_RPI(uint32_t kiloHertz, uint8_t SPICEX_PIN)
 {
-	_KiloHertz = kiloHertz;
-	_SPICEX_CS_IO = SPICEX_PIN;
+	_OwnedTransport.reset(new MAX7219_TransportHWSPI(kiloHertz, SPICEX_PIN));
+	_Transport = _OwnedTransport.get();
 	_HardwareSPI = true;
 }
+#endif
+
+/*!
+	@brief Constructor for class MAX7219_SS_RPI with a user supplied transport
+	@param transport The bus used to send data, owned by the caller and must outlive this object
+	@note The transport can be any MAX7219_Transport, for example MAX7219_TransportRecorder
+		to run the library without hardware.
+*/
+MAX7219_SS_RPI::MAX7219_SS_RPI(MAX7219_Transport *transport)
+{
+	_Transport = transport;
+	_HardwareSPI = false;
+}
+
+/*!
+	@brief Destructor, stops the render thread if running
+*/
+MAX7219_SS_RPI::~MAX7219_SS_RPI()
+{
+	StopAsync();
+}
 
 /*!
 	@brief End display operations, called at end of program before closing bcm2835 library.
@@ -44,15 +141,7 @@ MAX7219_SS_RPI::MAX7219_SS_RPI(uint32_t kiloHertz, uint8_t SPICEX_PIN)
 */
 void MAX7219_SS_RPI::DisplayEndOperations(void)
 {
-	if (_HardwareSPI == false)
-	{
-		MAX7219_CS_SetLow;
-		MAX7219_CLK_SetLow;
-		MAX7219_DIN_SetLow;
-	}else
-	{
-		bcm2835_spi_end();
-	}
+	_Transport->End();
 }
 
 /*!
@@ -62,6 +151,13 @@ void MAX7219_SS_RPI::DisplayEndOperations(void)
 bool MAX7219_SS_RPI::GetHardwareSPI(void)
 {return _HardwareSPI;}
 
+/*!
+	@brief get the transport used to send data to the displays
+	@return pointer to the transport
+*/
+MAX7219_Transport* MAX7219_SS_RPI::GetTransport(void)
+{return _Transport;}
+
 /*!
 	@brief get value of Library version number 
 	@return Library version number 130 = 1.3.0
@@ -73,32 +169,25 @@ uint16_t MAX7219_SS_RPI::GetLibVersionNum(void)
 	@brief Init the display
 	@param numDigits scan limit set to 8 normally , advanced use only 
 	@param decodeMode Must users will use 0x00 here
-	@return 1 if successful, 0 otherwise (perhaps because you are not running as root)
+	@return 1 if successful, 0 otherwise (perhaps because you are not running as root,
+		or the render thread is running, see StopAsync)
 	@note when cascading supplies init display one first always!
 */
 bool MAX7219_SS_RPI::InitDisplay(ScanLimit_e numDigits, DecodeMode_e decodeMode)
 {
+	if (_AsyncRunning) return false; // render thread owns the shadow registers
 	if (_CurrentDisplayNumber == 1)
 	{
-		if (_HardwareSPI == false )
+		if (_Transport == nullptr || !_Transport->Begin())
 		{
-			MAX7219_CS_SetDigitalOutput;
-			MAX7219_CLK_SetDigitalOutput;
-			MAX7219_DIN_SetDigitalOutput;
-			MAX7219_CS_SetHigh;
-		}else
-		{
-			if(!bcm2835_spi_begin())
-			{
-				return false;
-			}
-			MAX7219SPIHWSettings();
+			return false;
 		}
 		MAX7219_MilliSecondDelay(50); // small init delay before commencing transmissions
 	}
 	
 	_NoDigits = numDigits+1;
 	CurrentDecodeMode = decodeMode;
+	_ShadowValid[_CurrentDisplayNumber-1] = 0; // chip state unknown until init writes land
 	
 	SetScanLimit(numDigits);
 	SetDecodeMode(decodeMode);
@@ -110,6 +199,120 @@ bool MAX7219_SS_RPI::InitDisplay(ScanLimit_e numDigits, DecodeMode_e decodeMode)
 }
 
 
+/*!
+	@brief Init and clear every display in the cascade with chain wide transactions
+	@param numChips number of displays in the cascade, 1 to MAX7219_MAX_DISPLAYS, sets the chain length
+	@param config array of numChips settings, config[0] for display one, nullptr = eight digits,
+		no decode and default brightness on every display. The scan limit must be the same on every display.
+	@return true if successful, false if the scan limits differ (nothing is sent), the render thread
+		is running (see StopAsync) or the bus could not be started (perhaps because you are not running as root)
+	@details Replaces SetCurrentDisplayNumber and InitDisplay for each display. The init delay is applied
+		once, then each register is written to all displays in one transaction: test mode off, scan limit,
+		decode mode, brightness, blank digits (Code B blank on decoded digits), then shutdown off,
+		so the displays come on already cleared. That is at most 13 transactions whatever the chain length.
+		The display functions lay text out over one number of digits per display, so every display
+		needs the same scan limit. The decode mode used by ClearDisplay is taken from display one.
+*/
+bool MAX7219_SS_RPI::InitChain(uint8_t numChips, const ChipConfig_t *config)
+{
+	if (_AsyncRunning) return false; // render thread owns the shadow registers
+	if (config != nullptr)
+	{
+		const uint8_t chips = (numChips == 0) ? 1 : (numChips > MAX7219_MAX_DISPLAYS) ? MAX7219_MAX_DISPLAYS : numChips;
+		for (uint8_t display = 1; display < chips; display++)
+		{
+			if ((config[display].ScanLimit & ScanEightDigit) != (config[0].ScanLimit & ScanEightDigit))
+				return false; // mixed scan limits, text would land on digits that are not scanned
+		}
+	}
+	if (_Transport == nullptr || !_Transport->Begin())
+	{
+		return false;
+	}
+	MAX7219_MilliSecondDelay(50); // small init delay before commencing transmissions
+
+	SetChainLength(numChips);
+	const ChipConfig_t defaultConfig = {ScanEightDigit, DecodeModeNone, IntensityDefault};
+	uint8_t scanLimit[MAX7219_MAX_DISPLAYS];
+	uint8_t decodeMode[MAX7219_MAX_DISPLAYS];
+	uint8_t intensity[MAX7219_MAX_DISPLAYS];
+	uint8_t off[MAX7219_MAX_DISPLAYS];
+	uint8_t on[MAX7219_MAX_DISPLAYS];
+	for (uint8_t display = 0; display < _ChainLength; display++)
+	{
+		const ChipConfig_t &chip = (config != nullptr) ? config[display] : defaultConfig;
+		scanLimit[display] = chip.ScanLimit & ScanEightDigit;
+		decodeMode[display] = chip.DecodeMode;
+		intensity[display] = chip.Intensity & IntensityMax;
+		off[display] = 0;
+		on[display] = 1;
+		_ShadowValid[display] = 0; // chip state unknown until init writes land
+	}
+	_NoDigits = scanLimit[0] + 1;
+	CurrentDecodeMode = (DecodeMode_e)decodeMode[0];
+
+	const uint16_t length = _ChainLength * 2;
+	PackChain(MAX7219_REG_DisplayTest, off, _ChainTxBuffer, _ChainLength);
+	PackChain(MAX7219_REG_ScanLimit, scanLimit, _ChainTxBuffer + length, _ChainLength);
+	PackChain(MAX7219_REG_DecodeMode, decodeMode, _ChainTxBuffer + (length * 2), _ChainLength);
+	PackChain(MAX7219_REG_Intensity, intensity, _ChainTxBuffer + (length * 3), _ChainLength);
+	SendBatch(_ChainTxBuffer, length, 4);
+
+	uint8_t blank[MAX7219_MAX_DISPLAYS];
+	for (uint8_t digit = 0; digit < _NoDigits; digit++)
+	{
+		for (uint8_t display = 0; display < _ChainLength; display++)
+		{
+			blank[display] = (decodeMode[display] & (1 << digit)) ? CodeBFontSpace : 0x00;
+			_FrameBuffer[display][digit] = blank[display];
+		}
+		PackChain(digit + 1, blank, _ChainTxBuffer + (digit * length), _ChainLength);
+	}
+	SendBatch(_ChainTxBuffer, length, _NoDigits);
+
+	PackChain(MAX7219_REG_ShutDown, on, _ChainTxBuffer, _ChainLength);
+	SendTransaction(_ChainTxBuffer, length);
+	return true;
+}
+
+/*!
+	@brief Force a full refresh of every cascaded display
+	@details Resends every register with a known shadow value, bypassing the
+		shadow comparison in WriteDisplay. Control registers are sent before digits.
+		While the render thread runs the refresh holds the bus, frames wait until it is done.
+	@note Use after a power glitch or if display has been corrupted by noise on the bus.
+*/
+void MAX7219_SS_RPI::RefreshDisplay(void)
+{
+	std::unique_lock<std::mutex> busLock(_BusMutex, std::defer_lock);
+	if (_AsyncRunning) busLock.lock(); // render thread shares transport and shadow
+	for (uint8_t display = 0; display < _ChainLength; display++)
+	{
+		const uint16_t valid = _ShadowValid[display];
+		for (uint8_t reg = MAX7219_REG_DecodeMode; reg < MAX7219_NUM_REGISTERS; reg++)
+		{
+			if (valid & (1 << reg))
+				SendRegister(display, reg, _ShadowRegisters[display][reg]);
+		}
+		for (uint8_t reg = 1; reg < MAX7219_REG_DecodeMode; reg++)
+		{
+			if (valid & (1 << reg))
+				SendRegister(display, reg, _ShadowRegisters[display][reg]);
+		}
+	}
+}
+
+/*!
+	@brief Forget the shadow copy of all registers of every cascaded display
+	@details The next write to each register is always sent to the display.
+*/
+void MAX7219_SS_RPI::InvalidateShadow(void)
+{
+	std::unique_lock<std::mutex> busLock(_BusMutex, std::defer_lock);
+	if (_AsyncRunning) busLock.lock(); // render thread shares transport and shadow
+	memset(_ShadowValid, 0, sizeof(_ShadowValid));
+}
+
 /*!
 	@brief Clear the display
 */
@@ -186,71 +389,80 @@ void MAX7219_SS_RPI::SetSegment(uint8_t digit, uint8_t segment)
 	@brief Displays a text string on display
 	@param text pointer to character array containg text string
 	@param TextAlignment  left or right alignment or leading zeros
-	@note This method is overloaded, see also DisplayText(char *)
+	@note This method is overloaded, see also DisplayText(const char *) and DisplayText(std::string_view, TextAlignment_e)
 */
-void MAX7219_SS_RPI::DisplayText(char *text, TextAlignment_e TextAlignment){
-
-	char character;
-	char pos =0;
-
-	// We need the length of the string - no of decimal points set
-	uint8_t LengthOfStr = (_NoDigits);
-	LengthOfStr=strlen(text);
-	for(uint8_t index =0; text[index]; index++)
-	{
-		if(text[index] == '.') LengthOfStr--; // decrement string for dp's
-	}
-	if (LengthOfStr > (_NoDigits)) LengthOfStr = (_NoDigits);
-	
-	while ((character = (*text++)) && pos < _NoDigits)
-	{
-		if (*text == '.' && character != '.')
-		{
-			switch (TextAlignment) // Display a character with dp set 
-			{
-				case AlignLeft  : DisplayChar((_NoDigits-1)- pos ,character, DecPointOn); break;
-				case AlignRight : DisplayChar((LengthOfStr-1)- pos ,character, DecPointOn); break;
-				case AlignRightZeros: return; break;
-			}
-			pos++;
-			text++;
-		}  else
-		{
-			switch (TextAlignment) // Display a character without dp set 
-			{
-				case AlignLeft  : DisplayChar((_NoDigits-1) -pos, character, DecPointOff); break;
-				case AlignRight : DisplayChar((LengthOfStr-1) - pos, character, DecPointOff); break;
-				case AlignRightZeros : return; break;
-			}
-			pos++;
-		}
-	}
+void MAX7219_SS_RPI::DisplayText(const char *text, TextAlignment_e TextAlignment)
+{
+	uint8_t segments[MAX7219_NUM_DIGITS];
+	uint16_t first = 0;
+	uint16_t count = LayoutText(text, SIZE_MAX, TextAlignment, segments, _NoDigits, first);
+	WriteDigits(segments, first, count);
 }
 
+/*!
+	@brief Displays a text string on display, starting at left hand side
+	@param text  pointer to character array containg text string
+	@note This method is overloaded, see also DisplayText(const char *, TextAlignment_e )
+*/
+void MAX7219_SS_RPI::DisplayText(const char *text)
+{
+	DisplayText(text, AlignLeft);
+}
 
 /*!
 	@brief Displays a text string on display
-	@param text  pointer to character array containg text string
-	@note This method is overloaded, see also DisplayText(char *, TextAlignment_e )
+	@param text string containing text, need not be null terminated
+	@param TextAlignment  left or right alignment or leading zeros
+	@note This method is overloaded, see also DisplayText(const char *, TextAlignment_e )
 */
-void MAX7219_SS_RPI::DisplayText(char *text){
+void MAX7219_SS_RPI::DisplayText(std::string_view text, TextAlignment_e TextAlignment)
+{
+	uint8_t segments[MAX7219_NUM_DIGITS];
+	uint16_t first = 0;
+	uint16_t count = LayoutText(text.data(), text.length(), TextAlignment, segments, _NoDigits, first);
+	WriteDigits(segments, first, count);
+}
 
-	char character;
-	char pos = _NoDigits-1;
+/*!
+	@brief Convert text to seven segment codes in a single pass
+	@param text  pointer to characters
+	@param length number of characters, or SIZE_MAX for a null terminated string
+	@param TextAlignment left or right alignment or leading zeros
+	@param segments output, width seven segment codes, segments[0] is the left hand digit
+	@param width number of digits available
+	@param first output, index in segments of the first digit to be written
+	@return number of digits to be written, starting at segments[first]
+	@details A '.' following a character sets the decimal point of that character, otherwise
+		it takes a digit of its own. Text longer than width is truncated.
+		AlignLeft and AlignRight only cover the digits used by the text, AlignRightZeros
+		pads the left hand digits with zeros.
+*/
+uint16_t MAX7219_SS_RPI::LayoutText(const char *text, size_t length, TextAlignment_e TextAlignment,
+		uint8_t *segments, uint16_t width, uint16_t &first)
+{
+	uint16_t count = 0;
+	size_t index = 0;
+	while (index < length && text[index] && count < width)
+	{
+		const uint8_t character = text[index];
+		const uint8_t decimalPoint = (character != '.' && (index + 1) < length && text[index+1] == '.');
+		segments[count++] = SevenSegFetch(character, decimalPoint);
+		index += 1 + decimalPoint;
+	}
 
-	while ((character = (*text++)) && pos < _NoDigits)
+	first = 0;
+	if (TextAlignment == AlignLeft || count == width)
 	{
-		if (*text == '.' && character != '.')
-		{
-			DisplayChar(pos  ,character, DecPointOn);
-			pos--;
-			text++;
-		}  else
-		{
-			DisplayChar(pos  ,character, DecPointOff);
-			pos--;
-		}
+		return count;
 	}
+	memmove(segments + (width - count), segments, count);
+	if (TextAlignment == AlignRightZeros)
+	{
+		memset(segments, SevenSegFetch('0', DecPointOff), width - count);
+		return width;
+	}
+	first = width - count;
+	return count;
 }
 
 /*!
@@ -258,7 +470,7 @@ void MAX7219_SS_RPI::DisplayText(char *text){
 	@param text  pointer to character array containg text string
 	@note sets BCD code B font (0-9, E, H, L,P, and -) Built-in font
 */
-void MAX7219_SS_RPI::DisplayBCDText(char *text){
+void MAX7219_SS_RPI::DisplayBCDText(const char *text){
 
 	char character;
 	char pos =_NoDigits-1;
@@ -334,17 +546,94 @@ void MAX7219_SS_RPI:: DisplayTestMode(bool OnOff)
 }
 
 
+/*!
+	@brief sets the brightness of every display in the cascade in one transaction
+	@param brightness range 0x00 to 0x0F , 0x00 being least bright.
+*/
+void MAX7219_SS_RPI::SetBrightnessAll(uint8_t brightness)
+{
+	WriteChainAll(MAX7219_REG_Intensity, brightness & IntensityMax);
+}
+
+/*!
+	@brief sets a different brightness on each display in the cascade in one transaction
+	@param brightness array of ChainLength values 0x00 to 0x0F, brightness[0] for display one
+*/
+void MAX7219_SS_RPI::SetBrightnessChain(const uint8_t *brightness)
+{
+	uint8_t data[MAX7219_MAX_DISPLAYS];
+	for (uint8_t display = 0; display < _ChainLength; display++)
+	{
+		data[display] = brightness[display] & IntensityMax;
+	}
+	WriteChain(MAX7219_REG_Intensity, data);
+}
+
+/*!
+	@brief Turn on and off the Display Test Mode of every display in the cascade in one transaction
+	@param OnOff true = display test mode on , false display Test Mode off
+*/
+void MAX7219_SS_RPI::DisplayTestModeAll(bool OnOff)
+{
+	WriteChainAll(MAX7219_REG_DisplayTest, OnOff ? 1 : 0);
+}
+
+/*!
+	@brief Turn on and off the Shutdown Mode of every display in the cascade in one transaction
+	@param OnOff true = Shutdown mode on , false shutdown mode off
+*/
+void MAX7219_SS_RPI::ShutdownModeAll(bool OnOff)
+{
+	WriteChainAll(MAX7219_REG_ShutDown, OnOff ? 0 : 1);
+}
+
+/*!
+	@brief Set the scan limit of every display in the cascade in one transaction
+	@param numDigits The scan-limit register sets how many digits are displayed, from 1 to 8.
+	@note Advanced users only , read datasheet. Sets the number of digits used by the
+		display functions, as InitDisplay does.
+*/
+void MAX7219_SS_RPI::SetScanLimitAll(ScanLimit_e numDigits)
+{
+	_NoDigits = numDigits+1;
+	WriteChainAll(MAX7219_REG_ScanLimit, numDigits);
+}
+
+/*!
+	@brief Set the decode mode of every display in the cascade in one transaction
+	@param mode Set to 0x00 for most users
+	@note Sets the decode mode used by ClearDisplay, as InitDisplay does.
+*/
+void MAX7219_SS_RPI::SetDecodeModeAll(DecodeMode_e mode)
+{
+	CurrentDecodeMode = mode;
+	WriteChainAll(MAX7219_REG_DecodeMode, mode);
+}
+
 /*!
 	@brief Set the communication delay value
 	@param commDelay Set the communication delay value uS software SPI
 */
-void MAX7219_SS_RPI::SetCommDelay(uint16_t commDelay) {_CommDelay = commDelay;}
+void MAX7219_SS_RPI::SetCommDelay(uint16_t commDelay)
+{
+#ifndef MAX7219_NO_BCM2835
+	if (_SWSPITransport != nullptr) _SWSPITransport->SetCommDelay(commDelay);
+#else
+	(void)commDelay;
+#endif
+}
 
 /*!
 	@brief Get the communication delay value
-	@return Get the communication delay value uS Software SPi
+	@return Get the communication delay value uS Software SPi, 0 if not software SPI
 */
-uint16_t  MAX7219_SS_RPI::GetCommDelay(void) {return _CommDelay;}
+uint16_t  MAX7219_SS_RPI::GetCommDelay(void)
+{
+#ifndef MAX7219_NO_BCM2835
+	if (_SWSPITransport != nullptr) return _SWSPITransport->GetCommDelay();
+#endif
+	return 0;
+}
 
 /*!
 	@brief Get the Current Display Number
@@ -354,44 +643,323 @@ uint8_t MAX7219_SS_RPI::GetCurrentDisplayNumber(void){return _CurrentDisplayNumb
 
 /*!
 	@brief Set the Current Display Number 
-	@param DisplayNum Set the Current Display Number
+	@param DisplayNum Set the Current Display Number, 1 to MAX7219_MAX_DISPLAYS
 */
 void MAX7219_SS_RPI::SetCurrentDisplayNumber(uint8_t DisplayNum )
 {
 if (DisplayNum == 0 ) DisplayNum = 1; // Zero user error check
+if (DisplayNum > MAX7219_MAX_DISPLAYS) DisplayNum = MAX7219_MAX_DISPLAYS;
  
 _CurrentDisplayNumber  = DisplayNum  ;
+if (_CurrentDisplayNumber > _ChainLength) _ChainLength = _CurrentDisplayNumber;
 }
 
 /*!
-	@brief Display an integer and leading zeros optional
-	@param number  integer to display 2^32
-	@param TextAlignment enum text alignment, left or right alignment or leading zeros
+	@brief Get the number of displays in the cascade
+	@return number of displays in the cascade
 */
-void  MAX7219_SS_RPI::DisplayIntNum(unsigned long number, TextAlignment_e TextAlignment)
+uint8_t MAX7219_SS_RPI::GetChainLength(void){return _ChainLength;}
+
+/*!
+	@brief Get the number of digits of each display, set by InitDisplay
+	@return number of digits, 1 to 8
+*/
+uint8_t MAX7219_SS_RPI::GetNumDigits(void){return _NoDigits;}
+
+/*!
+	@brief Set the number of displays in the cascade
+	@param chainLength number of displays in the cascade, 1 to MAX7219_MAX_DISPLAYS
+	@note Grows automatically when SetCurrentDisplayNumber selects a display past the end of the chain.
+*/
+void MAX7219_SS_RPI::SetChainLength(uint8_t chainLength)
+{
+	if (chainLength == 0) chainLength = 1;
+	if (chainLength > MAX7219_MAX_DISPLAYS) chainLength = MAX7219_MAX_DISPLAYS;
+	_ChainLength = chainLength;
+	if (_CurrentDisplayNumber > _ChainLength) _CurrentDisplayNumber = _ChainLength;
+}
+
+/*!
+	@brief get value of _FrameBuffered
+	@return true digit writes are buffered until CommitFrame, false they are sent immediately
+*/
+bool MAX7219_SS_RPI::GetFrameBuffered(void){return _FrameBuffered;}
+
+/*!
+	@brief Turn on and off frame buffered mode
+	@param OnOff true = digit writes of all display functions are held in a frame buffer
+		covering every display in the cascade until CommitFrame is called. false = digit writes are sent immediately
+	@note Control registers (brightness, shutdown etc) are always sent immediately.
+		Cannot be turned off while the render thread runs, see StartAsync.
+*/
+void MAX7219_SS_RPI::SetFrameBuffered(bool OnOff)
+{
+	if (!OnOff && _AsyncRunning) return; // render thread needs the frame buffer
+	if (OnOff && !_FrameBuffered)
+	{
+		// start the frame from what is on the displays
+		for (uint8_t display = 0; display < MAX7219_MAX_DISPLAYS; display++)
+		{
+			for (uint8_t digit = 0; digit < MAX7219_NUM_DIGITS; digit++)
+			{
+				if (_ShadowValid[display] & (1 << (digit+1)))
+					_FrameBuffer[display][digit] = _ShadowRegisters[display][digit+1];
+			}
+		}
+	}
+	_FrameBuffered = OnOff;
+}
+
+/*!
+	@brief Send the frame buffer to every display in the cascade
+	@details Only changed digits are sent. The changes of all displays are packed together,
+		so a frame costs as many transactions of 2*ChainLength bytes as the most changed digits
+		of any one display, at most the number of scanned digits (see InitDisplay).
+		The transactions are handed to the transport as one batch.
+		If the render thread is running (see StartAsync) a copy of the frame is queued
+		and this returns without waiting for the bus.
+	@note See SetFrameBuffered
+*/
+void MAX7219_SS_RPI::CommitFrame(void)
+{
+	if (_AsyncRunning && _AsyncLatest)
+	{
+		const size_t frameBytes = sizeof(_FrameBuffer[0]) * _ChainLength;
+		if (_LastCommittedValid && _LastCommitted.ChainLength == _ChainLength &&
+			memcmp(_LastCommitted.Digits, _FrameBuffer, frameBytes) == 0)
+		{
+			_AsyncUnchanged++;
+			return;
+		}
+		_LastCommitted.ChainLength = _ChainLength;
+		memcpy(_LastCommitted.Digits, _FrameBuffer, frameBytes);
+		_LastCommittedValid = true;
+		_AsyncQueued++;
+		{
+			std::lock_guard<std::mutex> mailboxLock(_MailboxMutex);
+			if (_MailboxFull) _AsyncCoalesced++; // previous frame never sent
+			else _Mailbox.TimeStampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now().time_since_epoch()).count();
+			_Mailbox.ChainLength = _ChainLength;
+			memcpy(_Mailbox.Digits, _FrameBuffer, frameBytes);
+			_MailboxFull = true;
+		}
+		_AsyncWake.notify_one();
+		return;
+	}
+	if (_AsyncRunning)
+	{
+		Frame_t frame;
+		frame.ChainLength = _ChainLength;
+		memcpy(frame.Digits, _FrameBuffer, sizeof(frame.Digits[0]) * _ChainLength);
+		frame.TimeStampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+		if (!_AsyncQueue.Push(frame))
+		{
+			_AsyncDropped++;
+			return;
+		}
+		_AsyncQueued++;
+		const uint32_t depth = _AsyncQueue.Size();
+		if (depth > _AsyncHighWater) _AsyncHighWater = depth;
+		_AsyncWake.notify_one();
+		return;
+	}
+	FlushFrame(_FrameBuffer, _ChainLength);
+}
+
+/*!
+	@brief Start the render thread, frames from CommitFrame are queued and sent by the thread
+	@param queueDepth number of frames the queue can hold, frames committed while it is full are dropped
+	@return true if the thread started, false if already running or queueDepth is 0
+	@details Turns on frame buffered mode. The application thread writes to the frame buffer as normal
+		and calls CommitFrame, which only copies the frame into a lock free queue.
+		Control registers (brightness etc) are still sent immediately, in order with the thread.
+		InitDisplay and InitChain return false until StopAsync.
+	@note Only one application thread may call the display functions.
+*/
+bool MAX7219_SS_RPI::StartAsync(uint16_t queueDepth)
+{
+	if (_AsyncRunning || queueDepth == 0) return false;
+	_AsyncQueue.Reset(queueDepth);
+	_AsyncLatest = false;
+	return StartAsyncThread();
+}
+
+/*!
+	@brief Start the render thread in latest wins mode, only the newest committed frame is kept
+	@param maxRefreshHz maximum frames per second sent to the displays, 0 = as fast as the bus allows
+	@return true if the thread started, false if already running
+	@details As StartAsync but CommitFrame replaces any frame not yet sent (counted as coalesced)
+		and frames identical to the previous commit are dropped (counted as unchanged).
+		The render thread sends at most maxRefreshHz frames per second.
+*/
+bool MAX7219_SS_RPI::StartAsyncLatest(uint16_t maxRefreshHz)
 {
-	char values[_NoDigits+1];
-	char TextDisplay[6] = "%";
-	char TextRight[4] = "8ld";
-	char TextLeft[3] = "ld";
-	char TextLeadZero[5] = "08ld";
+	if (_AsyncRunning) return false;
+	_AsyncQueue.Reset(0);
+	_AsyncLatest = true;
+	_AsyncIntervalUs = (maxRefreshHz > 0) ? (1000000 / maxRefreshHz) : 0;
+	_MailboxFull = false;
+	_LastCommittedValid = false;
+	return StartAsyncThread();
+}
+
+/*!
+	@brief Reset statistics and start the render thread, see StartAsync and StartAsyncLatest
+	@return true
+*/
+bool MAX7219_SS_RPI::StartAsyncThread(void)
+{
+	SetFrameBuffered(true);
+	_AsyncQueued = 0;
+	_AsyncFlushed = 0;
+	_AsyncDropped = 0;
+	_AsyncHighWater = 0;
+	_AsyncLastLatencyUs = 0;
+	_AsyncMaxLatencyUs = 0;
+	_AsyncTotalLatencyUs = 0;
+	_AsyncCoalesced = 0;
+	_AsyncUnchanged = 0;
+	_AsyncRunning = true;
+	_AsyncThread = std::thread(&MAX7219_SS_RPI::AsyncThreadLoop, this);
+	return true;
+}
+
+/*!
+	@brief Stop the render thread after it has sent all queued frames
+	@note Frame buffered mode stays on, CommitFrame sends frames directly again.
+*/
+void MAX7219_SS_RPI::StopAsync(void)
+{
+	if (!_AsyncRunning) return;
+	_AsyncRunning = false;
+	_AsyncWake.notify_one();
+	if (_AsyncThread.joinable()) _AsyncThread.join();
+}
+
+/*!
+	@brief get state of render thread
+	@return true if render thread is running, see StartAsync
+*/
+bool MAX7219_SS_RPI::GetAsync(void){return _AsyncRunning;}
 
-	switch(TextAlignment)
+/*!
+	@brief Get statistics of the render thread
+	@param stats filled with queue depth, drops and flush latency, see AsyncStats_t
+*/
+void MAX7219_SS_RPI::GetAsyncStats(AsyncStats_t &stats)
+{
+	if (_AsyncLatest)
 	{
-		case AlignRight:
-			strcat(TextDisplay ,TextRight); // %8ld
-		break;
-		case AlignLeft:
-			strcat(TextDisplay ,TextLeft);  // %ld
-		break;
-		case AlignRightZeros:
-			strcat(TextDisplay ,TextLeadZero);  // %08ld
-		break;
+		std::lock_guard<std::mutex> mailboxLock(_MailboxMutex);
+		stats.QueueDepth = _MailboxFull ? 1 : 0;
+		stats.QueueCapacity = 1;
+	}else
+	{
+		stats.QueueDepth = _AsyncQueue.Size();
+		stats.QueueCapacity = _AsyncQueue.Capacity();
 	}
-	snprintf(values, _NoDigits+1, TextDisplay, number);
-	DisplayText(values);
+	stats.HighWater = _AsyncHighWater;
+	stats.FramesQueued = _AsyncQueued;
+	stats.FramesFlushed = _AsyncFlushed;
+	stats.FramesDropped = _AsyncDropped;
+	stats.FramesCoalesced = _AsyncCoalesced;
+	stats.FramesUnchanged = _AsyncUnchanged;
+	stats.LastLatencyUs = _AsyncLastLatencyUs;
+	stats.MaxLatencyUs = _AsyncMaxLatencyUs;
+	stats.MeanLatencyUs = (stats.FramesFlushed > 0) ? (uint32_t)(_AsyncTotalLatencyUs / stats.FramesFlushed) : 0;
 }
 
+/*!
+	@brief Get the bus counters of this display object
+	@param stats filled with register writes, suppressed writes, bytes, transactions and transport time
+	@note Counters run all the time, see ResetStats
+*/
+void MAX7219_SS_RPI::GetStats(Stats_t &stats)
+{
+	std::unique_lock<std::mutex> busLock(_BusMutex, std::defer_lock);
+	if (_AsyncRunning) busLock.lock();
+	stats = _Stats;
+	stats.TransportNs = (uint64_t)((double)_TransportTicks * InstrumentTickNs());
+}
+
+/*!
+	@brief Get the bus counters of one display in the cascade
+	@param displayNumber display in the cascade, 1 to MAX7219_MAX_DISPLAYS
+	@param stats filled with register writes, suppressed writes, bytes, transactions and transport time
+		of that display, zero if displayNumber is not valid
+*/
+void MAX7219_SS_RPI::GetChipStats(uint8_t displayNumber, ChipStats_t &stats)
+{
+	std::unique_lock<std::mutex> busLock(_BusMutex, std::defer_lock);
+	if (_AsyncRunning) busLock.lock();
+	if (displayNumber < 1 || displayNumber > MAX7219_MAX_DISPLAYS)
+	{
+		stats = ChipStats_t{};
+		return;
+	}
+	stats = _ChipStats[displayNumber - 1];
+	stats.TransportNs = (uint64_t)((double)_ChipTransportTicks[displayNumber - 1] * InstrumentTickNs());
+}
+
+/*!
+	@brief Set all bus counters to zero
+*/
+void MAX7219_SS_RPI::ResetStats(void)
+{
+	std::unique_lock<std::mutex> busLock(_BusMutex, std::defer_lock);
+	if (_AsyncRunning) busLock.lock();
+	_Stats = Stats_t{};
+	_TransportTicks = 0;
+	memset(_ChipStats, 0, sizeof(_ChipStats));
+	memset(_ChipTransportTicks, 0, sizeof(_ChipTransportTicks));
+}
+
+/*!
+	@brief Start recording every transaction sent to the displays in a capture file
+	@param path capture file to create, see MAX7219_7SEG_RPI_Capture.hpp for the format
+	@return false if the file could not be created
+	@note Records are buffered, the file is complete after StopCapture. Replay with tools/replay.
+*/
+bool MAX7219_SS_RPI::StartCapture(const char *path)
+{
+	std::unique_ptr<MAX7219_CaptureWriter> capture(new MAX7219_CaptureWriter());
+	if (!capture->Open(path)) return false;
+	std::unique_lock<std::mutex> busLock(_BusMutex, std::defer_lock);
+	if (_AsyncRunning) busLock.lock();
+	_Capture = std::move(capture);
+	return true;
+}
+
+/*!
+	@brief Stop recording, write buffered records and close the capture file
+*/
+void MAX7219_SS_RPI::StopCapture(void)
+{
+	std::unique_lock<std::mutex> busLock(_BusMutex, std::defer_lock);
+	if (_AsyncRunning) busLock.lock();
+	_Capture.reset();
+}
+
+/*!
+	@brief get state of capture
+	@return true if recording to a capture file, see StartCapture
+*/
+bool MAX7219_SS_RPI::GetCapture(void) {return _Capture != nullptr;}
+
+/*!
+	@brief Display an integer and leading zeros optional
+	@param number  integer to display 2^32
+	@param TextAlignment enum text alignment, left or right alignment or leading zeros
+	@note Right alignment blanks the unused digits, left alignment only writes the digits of the number.
+*/
+void  MAX7219_SS_RPI::DisplayIntNum(unsigned long number, TextAlignment_e TextAlignment)
+{
+	uint8_t segments[MAX7219_NUM_DIGITS];
+	uint16_t count = FormatNumber(number, false, 0, TextAlignment, segments, _NoDigits);
+	WriteDigits(segments, 0, (TextAlignment == AlignLeft) ? count : _NoDigits);
+}
 
 /*!
 	@brief Display an integer in a nibble (4 digits on display)
@@ -404,113 +972,689 @@ void  MAX7219_SS_RPI::DisplayIntNum(unsigned long number, TextAlignment_e TextAl
 */
 void MAX7219_SS_RPI::DisplayDecNumNibble(uint16_t  numberUpper, uint16_t numberLower, TextAlignment_e TextAlignment)
 {
-	char valuesUpper[_NoDigits+ 1];
-	char valuesLower[_NoDigits/2 + 1];
-	char TextDisplay[5] = "%";
-	char TextRight[3] = "4d";
-	char TextLeft[4] = "-4d";
-	char TextLeadZero[4] = "04d";
+	uint8_t segments[MAX7219_NUM_DIGITS];
+	const uint16_t nibbleWidth = _NoDigits/2;
+	FormatNumber(numberUpper, false, 0, TextAlignment, segments, nibbleWidth);
+	FormatNumber(numberLower, false, 0, TextAlignment, segments + nibbleWidth, nibbleWidth);
+	WriteDigits(segments, 0, nibbleWidth*2);
+}
+
+/*!
+	@brief Display a signed fixed point number
+	@param number value in units of the last decimal place, e.g. 1245 with 2 places is 12.45
+	@param decimalPlaces number of digits after the decimal point, 0 for a signed integer
+	@param TextAlignment enum text alignment, left or right alignment or leading zeros
+	@note Right alignment blanks the unused digits, left alignment only writes the digits of the number.
+*/
+void MAX7219_SS_RPI::DisplayFixedNum(long number, uint8_t decimalPlaces, TextAlignment_e TextAlignment)
+{
+	uint8_t segments[MAX7219_NUM_DIGITS];
+	const bool negative = (number < 0);
+	const unsigned long magnitude = negative ? (0UL - (unsigned long)number) : (unsigned long)number;
+	uint16_t count = FormatNumber(magnitude, negative, decimalPlaces, TextAlignment, segments, _NoDigits);
+	WriteDigits(segments, 0, (TextAlignment == AlignLeft) ? count : _NoDigits);
+}
 
-	switch(TextAlignment)
+/*!
+	@brief Display a floating point number
+	@param number value to display, rounded to decimalPlaces
+	@param decimalPlaces number of digits after the decimal point
+	@param TextAlignment enum text alignment, left or right alignment or leading zeros
+	@note Displays dashes if the number is too big for a long or not a number.
+*/
+void MAX7219_SS_RPI::DisplayFloatNum(double number, uint8_t decimalPlaces, TextAlignment_e TextAlignment)
+{
+	double scaled = number;
+	for (uint8_t place = 0; place < decimalPlaces; place++) scaled *= 10.0;
+	scaled += (scaled < 0) ? -0.5 : 0.5;
+
+	if (!(scaled > (double)LONG_MIN && scaled < (double)LONG_MAX)) // also catches NaN
 	{
-		case AlignRight: strcat(TextDisplay ,TextRight); break; // %4d
-		case AlignLeft: strcat(TextDisplay ,TextLeft); break;  // %-4d
-		case AlignRightZeros: strcat(TextDisplay ,TextLeadZero); break; // %04d
+		uint8_t segments[MAX7219_NUM_DIGITS];
+		memset(segments, SevenSegFetch('-', DecPointOff), sizeof(segments));
+		WriteDigits(segments, 0, _NoDigits);
+		return;
 	}
-
-	snprintf(valuesUpper, _NoDigits/2 + 1, TextDisplay, numberUpper);
-	snprintf(valuesLower, _NoDigits/2 + 1, TextDisplay, numberLower);
-	strcat(valuesUpper ,valuesLower);
-	
-	DisplayText(valuesUpper);
+	DisplayFixedNum((long)scaled, decimalPlaces, TextAlignment);
 }
 
+/*!
+	@brief Get the width of the wide display, every digit of every display in the cascade
+	@return ChainLength * number of digits, see SetChainLength and InitDisplay
+*/
+uint16_t MAX7219_SS_RPI::GetWideWidth(void){return _ChainLength * _NoDigits;}
 
+/*!
+	@brief Displays a text string across all displays in the cascade as one wide display
+	@param text string containing text, need not be null terminated
+	@param TextAlignment left or right alignment or leading zeros, over the whole wide display
+	@details Display one is the left hand display. The text flows from one display into the next
+		and is sent as one frame, see CommitFrame. Text longer than GetWideWidth is truncated.
+*/
+void MAX7219_SS_RPI::DisplayTextWide(std::string_view text, TextAlignment_e TextAlignment)
+{
+	uint8_t segments[MAX7219_MAX_DISPLAYS*MAX7219_NUM_DIGITS];
+	uint16_t first = 0;
+	const uint16_t width = GetWideWidth();
+	uint16_t count = LayoutText(text.data(), text.length(), TextAlignment, segments, width, first);
+	WideKey_t cacheKey;
+	cacheKey.Length = 0;
+	if (first == 0 && count == width) // shorter text keeps the other digits, its frame is never cached
+	{
+		// LayoutText reads at most a character and a '.' per digit, the rest cannot change the frame
+		const size_t used = (text.length() < (size_t)width * 2) ? text.length() : (size_t)width * 2;
+		WideCacheKey(0, text.data(), used, TextAlignment, cacheKey);
+		if (WriteWideCached(cacheKey)) return;
+	}
+	WriteWide(segments, first, count, cacheKey);
+}
 
-// Private methods
+/*!
+	@brief Display an integer across all displays in the cascade as one wide display
+	@param number  integer to display 2^32
+	@param TextAlignment enum text alignment, left or right alignment or leading zeros
+	@note See DisplayTextWide and DisplayIntNum
+*/
+void MAX7219_SS_RPI::DisplayIntNumWide(unsigned long number, TextAlignment_e TextAlignment)
+{
+	uint8_t segments[MAX7219_MAX_DISPLAYS*MAX7219_NUM_DIGITS];
+	const uint16_t width = GetWideWidth();
+	uint16_t count = 0;
+	WideKey_t cacheKey;
+	cacheKey.Length = 0;
+	if (TextAlignment == AlignLeft)
+	{
+		// a left aligned number shorter than the wide display keeps the other digits, its frame is never cached
+		count = FormatNumber(number, false, 0, TextAlignment, segments, width);
+		if (count < width)
+		{
+			WriteWide(segments, 0, count, cacheKey);
+			return;
+		}
+	}
+	WideCacheKey(1, &number, sizeof(number), TextAlignment, cacheKey);
+	if (WriteWideCached(cacheKey)) return;
+	if (TextAlignment != AlignLeft) FormatNumber(number, false, 0, TextAlignment, segments, width);
+	WriteWide(segments, 0, width, cacheKey);
+}
 
- /*!
-	@brief Shifts out a uint8_t of data on to the MAX7219 SPI-like bus
-	@param value The uint8_t of data to shift out
-	@note _CommDelay microsecond delay may have to be adjusted depending on processor
+/*!
+	@brief Display a signed fixed point number across all displays in the cascade as one wide display
+	@param number value in units of the last decimal place, e.g. 1245 with 2 places is 12.45
+	@param decimalPlaces number of digits after the decimal point, 0 for a signed integer
+	@param TextAlignment enum text alignment, left or right alignment or leading zeros
+	@note See DisplayTextWide and DisplayFixedNum
 */
-void MAX7219_SS_RPI::HighFreqshiftOut(uint8_t value)
+void MAX7219_SS_RPI::DisplayFixedNumWide(long number, uint8_t decimalPlaces, TextAlignment_e TextAlignment)
 {
+	uint8_t segments[MAX7219_MAX_DISPLAYS*MAX7219_NUM_DIGITS];
+	const uint16_t width = GetWideWidth();
+	const bool negative = (number < 0);
+	const unsigned long magnitude = negative ? (0UL - (unsigned long)number) : (unsigned long)number;
+	uint16_t count = 0;
+	WideKey_t cacheKey;
+	cacheKey.Length = 0;
+	if (TextAlignment == AlignLeft)
+	{
+		// a left aligned number shorter than the wide display keeps the other digits, its frame is never cached
+		count = FormatNumber(magnitude, negative, decimalPlaces, TextAlignment, segments, width);
+		if (count < width)
+		{
+			WriteWide(segments, 0, count, cacheKey);
+			return;
+		}
+	}
+	const long content[2] = {number, decimalPlaces};
+	WideCacheKey(2, content, sizeof(content), TextAlignment, cacheKey);
+	if (WriteWideCached(cacheKey)) return;
+	if (TextAlignment != AlignLeft) FormatNumber(magnitude, negative, decimalPlaces, TextAlignment, segments, width);
+	WriteWide(segments, 0, width, cacheKey);
+}
 
-	for (uint8_t bit = 0; bit < 8; bit++)
+/*!
+	@brief Turn on, resize or turn off the cache of wide display frames
+	@param entries number of frames kept, 0 = cache off. Each entry takes
+		MAX7219_MAX_DISPLAYS * 40 + 4 bytes, allocated here.
+	@details DisplayTextWide, DisplayIntNumWide and DisplayFixedNumWide look up their arguments
+		(with chain length and digits per display) by a 64 bit hash, the arguments are stored with
+		the frame and compared on a hash match, see MAX7219_FrameCache. A number seen before skips
+		the formatting and, when every digit of a display has to change, is sent as its prebuilt
+		chain transactions. Other hits only send the digits that changed, as CommitFrame.
+		Only writes covering the whole wide display are cached: text is laid out first, and text or
+		AlignLeft numbers shorter than the display (which leave digits as they were) are not looked up,
+		so they do not count as misses. The least recently used frame is evicted.
+*/
+void MAX7219_SS_RPI::SetFrameCache(uint16_t entries)
+{
+	if (entries == 0)
 	{
-		!!(value & (1 << (7 - bit))) ? MAX7219_DIN_SetHigh: MAX7219_DIN_SetLow; // MSBFIRST
-		MAX7219_CLK_SetHigh;
-		MAX7219_MicroSecondDelay(_CommDelay);
-		MAX7219_CLK_SetLow;
-		MAX7219_MicroSecondDelay(_CommDelay);
+		_FrameCache.reset();
+		return;
 	}
+	// per entry: frame image, then one chain wide transaction per digit
+	_FrameCache.reset(new MAX7219_FrameCache(entries, MAX7219_MAX_DISPLAYS * MAX7219_NUM_DIGITS * 3,
+		sizeof(WideKey_t::Bytes)));
+}
+
+/*!
+	@brief Get statistics of the cache of wide display frames
+	@param stats filled with hits, misses, evictions and entries, zero if the cache is off
+*/
+void MAX7219_SS_RPI::GetFrameCacheStats(MAX7219_FrameCache::Stats_t &stats)
+{
+	if (!_FrameCache)
+	{
+		stats = MAX7219_FrameCache::Stats_t{};
+		return;
+	}
+	_FrameCache->GetStats(stats);
+}
+
+/*!
+	@brief Convert a number to seven segment codes without printf
+	@param magnitude absolute value of the number, in units of the last decimal place
+	@param negative true to show a minus sign
+	@param decimalPlaces number of digits after the decimal point, any value, leading zeros are added
+	@param TextAlignment left, right with blanks or right with leading zeros
+	@param segments output, width seven segment codes, segments[0] is the left hand digit
+	@param width number of digits available
+	@return number of digits taken by the number itself. Unused digits are blank.
+		If the number is wider than width the left hand digits are kept.
+	@note Right alignment pads to width, for 8 digits this is the output of the %8ld, %08ld and %ld
+		formats used before. With fewer digits scanned those formats were cut to the left hand
+		digits of an 8 wide field (mostly blanks), this shows the number on the digits there are.
+*/
+uint16_t MAX7219_SS_RPI::FormatNumber(unsigned long magnitude, bool negative, uint8_t decimalPlaces,
+		TextAlignment_e TextAlignment, uint8_t *segments, uint16_t width)
+{
+	uint8_t digits[UINT8_MAX + 2]; // least significant first, a zero before the point for any decimalPlaces
+	uint16_t numDigits = 0;
+	do
+	{
+		digits[numDigits++] = SevenSegFetch('0' + (magnitude % 10), DecPointOff);
+		magnitude /= 10;
+	} while ((magnitude > 0 || numDigits <= decimalPlaces) && numDigits < sizeof(digits) - 1);
+	if (decimalPlaces > 0 && decimalPlaces < numDigits)
+		digits[decimalPlaces] |= SevenSegDecimalPoint;
+
+	const uint16_t length = numDigits + (negative ? 1 : 0);
+	uint16_t pad = 0;
+	if (TextAlignment != AlignLeft && length < width)
+		pad = width - length;
+
+	uint16_t pos = 0;
+	if (TextAlignment == AlignRight)
+		for (; pos < pad; pos++) segments[pos] = SevenSegFetch(' ', DecPointOff);
+	if (negative && pos < width)
+		segments[pos++] = SevenSegFetch('-', DecPointOff);
+	if (TextAlignment == AlignRightZeros)
+		for (uint16_t zero = 0; zero < pad; zero++) segments[pos++] = SevenSegFetch('0', DecPointOff);
+	while (numDigits > 0 && pos < width)
+		segments[pos++] = digits[--numDigits];
+	const uint16_t count = (length < width) ? length : width;
+	while (pos < width)
+		segments[pos++] = SevenSegFetch(' ', DecPointOff);
+	return count;
 }
 
+// Private methods
 
 /*!
 	@brief Fetch's the seven segment code for a given ASCII code from the font
-	@param character The ASCII character to  lookup
+	@param character The ASCII character to  lookup, characters outside font are blank
 	@param decimalPoint Is the decimal point(dp) to be set or not.
 	@return The seven segment representation of the ASCII character in a byte dpabcdefg
 */
 uint8_t MAX7219_SS_RPI::ASCIIFetch(uint8_t character, DecimalPoint_e decimalPoint)
 {
-	if (character<=31 || character>=123) {return 0;} // check ASCII font bounds
+	return SevenSegFetch(character, decimalPoint);
+}
 
-	const uint8_t  AsciiOffset = 0x20; // The font starts at ASCII 0x20 . space
-	uint8_t returnCharValue =0;
+/*!
+	@brief Write a run of seven segment codes to the digits of the current display
+	@param segments seven segment codes, segments[0] is the left hand digit
+	@param first index in segments of the first digit to write
+	@param count number of digits to write
+*/
+void MAX7219_SS_RPI::WriteDigits(const uint8_t *segments, uint16_t first, uint16_t count)
+{
+	for (uint16_t index = first; index < first + count; index++)
+	{
+		WriteDisplay(_NoDigits - index, segments[index]);
+	}
+}
 
-	switch (decimalPoint)
+/*!
+	@brief Write a run of seven segment codes to the wide display and commit them as one frame
+	@param segments seven segment codes, segments[0] is the left hand digit of display one
+	@param first index in segments of the first digit to write
+	@param count number of digits to write
+	@param cacheKey key of the frame in the frame cache, see WideCacheKey, ignored if the cache is off
+	@note Frame buffered mode is turned on for the write and restored after, other displays
+		and digits keep their contents.
+*/
+void MAX7219_SS_RPI::WriteWide(const uint8_t *segments, uint16_t first, uint16_t count, const WideKey_t &cacheKey)
+{
+	const bool frameBuffered = _FrameBuffered;
+	SetFrameBuffered(true);
+	for (uint16_t index = first; index < first + count; index++)
 	{
-		case DecPointOn :
-			returnCharValue  = pSevenSegASCIIFont[character - AsciiOffset];
-			returnCharValue |= (1<<7);
-			return (returnCharValue);
-		break;
-		case DecPointOff :
-			return pSevenSegASCIIFont[character - AsciiOffset];
-		break;
+		_FrameBuffer[index / _NoDigits][_NoDigits - 1 - (index % _NoDigits)] = segments[index];
 	}
+	const int32_t index = (_FrameCache && cacheKey.Length > 0 && first == 0 && count == GetWideWidth()) ?
+		_FrameCache->Insert(cacheKey.Hash, cacheKey.Bytes, cacheKey.Length) : -1;
+	if (index >= 0)
+	{
+		// entry: image [display][digit] of the wide display, then one transaction per digit
+		uint8_t *image = _FrameCache->GetEntry(index);
+		uint8_t *wire = image + GetWideWidth();
+		const uint16_t length = _ChainLength * 2;
+		for (uint8_t display = 0; display < _ChainLength; display++)
+		{
+			for (uint8_t digit = 0; digit < _NoDigits; digit++)
+			{
+				const uint8_t slot = (_ChainLength - 1 - display) * 2; // first pair lands in the last display
+				image[(display * _NoDigits) + digit] = _FrameBuffer[display][digit];
+				wire[(digit * length) + slot] = digit + 1;
+				wire[(digit * length) + slot + 1] = _FrameBuffer[display][digit];
+			}
+		}
+	}
+	CommitFrame();
+	SetFrameBuffered(frameBuffered);
+}
 
-	return 0;
+/*!
+	@brief Write a wide display frame from the frame cache
+	@param cacheKey key of the frame, see WideCacheKey
+	@return true if the frame was in the cache and has been written, false if it must be built
+	@details If a display needs every digit changed, the frame costs that many transactions anyway
+		and the prebuilt transactions are sent as they are. Otherwise the frame goes through CommitFrame
+		so only changed digits are sent, nothing if the displays already show it.
+		While the render thread runs the frame is always queued with CommitFrame, see StartAsync.
+*/
+bool MAX7219_SS_RPI::WriteWideCached(const WideKey_t &cacheKey)
+{
+	if (!_FrameCache || cacheKey.Length == 0) return false;
+	const int32_t index = _FrameCache->Find(cacheKey.Hash, cacheKey.Bytes, cacheKey.Length);
+	if (index < 0) return false;
+	const uint8_t *image = _FrameCache->GetEntry(index);
+	const uint8_t *wire = image + GetWideWidth();
+
+	const bool frameBuffered = _FrameBuffered;
+	SetFrameBuffered(true);
+	for (uint8_t display = 0; display < _ChainLength; display++)
+	{
+		for (uint8_t digit = 0; digit < _NoDigits; digit++)
+		{
+			_FrameBuffer[display][digit] = image[(display * _NoDigits) + digit];
+		}
+	}
+	if (_AsyncRunning)
+	{
+		// the render thread owns the shadow registers, queue the frame for it
+		CommitFrame();
+		SetFrameBuffered(frameBuffered);
+		return true;
+	}
+
+	uint8_t maxChanged = 0;
+	for (uint8_t display = 0; display < _ChainLength; display++)
+	{
+		uint8_t changed = 0;
+		for (uint8_t digit = 0; digit < _NoDigits; digit++)
+		{
+			const uint8_t reg = digit + 1;
+			if (!(_ShadowValid[display] & (1 << reg)) || _ShadowRegisters[display][reg] != _FrameBuffer[display][digit]) changed++;
+		}
+		if (changed > maxChanged) maxChanged = changed;
+	}
+
+	if (maxChanged == _NoDigits)
+	{
+		for (uint8_t display = 0; display < _ChainLength; display++)
+		{
+			for (uint8_t digit = 0; digit < _NoDigits; digit++)
+			{
+				_ShadowRegisters[display][digit + 1] = _FrameBuffer[display][digit];
+				_ShadowValid[display] |= (1 << (digit + 1));
+			}
+			_ChipStats[display].RegisterWrites += _NoDigits;
+		}
+		_Stats.RegisterWrites += (uint64_t)_ChainLength * _NoDigits;
+		SendBatch(wire, _ChainLength * 2, _NoDigits);
+	}else
+	{
+		CommitFrame();
+	}
+	SetFrameBuffered(frameBuffered);
+	return true;
+}
+
+/*!
+	@brief Key of a wide display frame in the frame cache
+	@param function which wide display function, 0 text, 1 integer, 2 fixed point
+	@param content the arguments that decide the frame
+	@param length size of content in bytes
+	@param TextAlignment alignment argument
+	@param cacheKey filled with the arguments, chain length and digits per display and their
+		64 bit hash, Length 0 (not cached) if the cache is off
+*/
+void MAX7219_SS_RPI::WideCacheKey(uint8_t function, const void *content, size_t length, TextAlignment_e TextAlignment, WideKey_t &cacheKey)
+{
+	cacheKey.Hash = 0;
+	cacheKey.Length = 0;
+	const uint8_t layout[4] = {function, TextAlignment, _ChainLength, _NoDigits};
+	if (!_FrameCache || length > sizeof(cacheKey.Bytes) - sizeof(layout)) return;
+	memcpy(cacheKey.Bytes, layout, sizeof(layout));
+	memcpy(cacheKey.Bytes + sizeof(layout), content, length);
+	cacheKey.Length = (uint16_t)(sizeof(layout) + length);
+	cacheKey.Hash = MAX7219_FrameCache::Hash(cacheKey.Bytes, cacheKey.Length);
 }
 
 /*!
 	@brief Write to the MAX7219 display register
 	@param RegisterCode the register to write to
 	@param data The data byte to send to register
+	@note The write is skipped if the shadow copy shows the register already holds data,
+		see RefreshDisplay() and InvalidateShadow()
 */
 void MAX7219_SS_RPI::WriteDisplay( uint8_t RegisterCode, uint8_t data) 
 {
+	if (_FrameBuffered && RegisterCode >= 1 && RegisterCode <= MAX7219_NUM_DIGITS)
+	{
+		_FrameBuffer[_CurrentDisplayNumber - 1][RegisterCode - 1] = data;
+		return; // sent by CommitFrame
+	}
+	std::unique_lock<std::mutex> busLock(_BusMutex, std::defer_lock);
+	if (_AsyncRunning) busLock.lock(); // render thread shares transport and shadow
+	const uint8_t display = _CurrentDisplayNumber - 1;
+	if (RegisterCode != MAX7219_REG_NOP && RegisterCode < MAX7219_NUM_REGISTERS &&
+		(_ShadowValid[display] & (1 << RegisterCode)) && _ShadowRegisters[display][RegisterCode] == data)
+	{
+		_Stats.WritesSuppressed++;
+		_ChipStats[display].WritesSuppressed++;
+		return; // register already holds this value
+	}
+	SendRegister(display, RegisterCode, data);
+}
+
+/*!
+	@brief Send one register write to one display of the chain and record it in the shadow
+	@param display display index in the cascade, 0 for display one
+	@param RegisterCode the register to write to
+	@param data The data byte to send to register
+	@note No shadow comparison, see WriteDisplay. Hold _BusMutex while the render thread runs.
+*/
+void MAX7219_SS_RPI::SendRegister(uint8_t display, uint8_t RegisterCode, uint8_t data)
+{
+	if (RegisterCode != MAX7219_REG_NOP && RegisterCode < MAX7219_NUM_REGISTERS)
+	{
+		_ShadowRegisters[display][RegisterCode] = data;
+		_ShadowValid[display] |= (1 << RegisterCode);
+		_Stats.RegisterWrites++;
+		_ChipStats[display].RegisterWrites++;
+	}
+
+	// NOP for every other display of the chain, displays past this one would otherwise
+	// latch the stale data shifted through to them. The first pair lands in the last display.
+	// _TxArena holds only NOPs between calls, so just the payload pair is written and put back.
+	const uint8_t slot = (_ChainLength - 1 - display) * 2;
+	_TxArena[slot] = RegisterCode;
+	_TxArena[slot + 1] = data;
+	SendTransaction(_TxArena, _ChainLength*2);
+	_TxArena[slot] = MAX7219_REG_NOP;
+	_TxArena[slot + 1] = 0x00;
+}
 
-	if (_HardwareSPI == false)
+/*!
+	@brief Write the same register on every display in the cascade in one transaction
+	@param RegisterCode the register to write to
+	@param data array of ChainLength data bytes, data[0] for display one
+	@note The write is skipped if the shadow copy shows every display already holds its data
+*/
+void MAX7219_SS_RPI::WriteChain(uint8_t RegisterCode, const uint8_t *data)
+{
+	std::unique_lock<std::mutex> busLock(_BusMutex, std::defer_lock);
+	if (_AsyncRunning) busLock.lock();
+	bool changed = false;
+	for (uint8_t display = 0; display < _ChainLength; display++)
 	{
-		MAX7219_CS_SetLow;
-		HighFreqshiftOut(RegisterCode);
-		HighFreqshiftOut(data);
-		if (_CurrentDisplayNumber  > 1)
+		if (!(_ShadowValid[display] & (1 << RegisterCode)) || _ShadowRegisters[display][RegisterCode] != data[display])
+			changed = true;
+	}
+	if (!changed)
+	{
+		_Stats.WritesSuppressed += _ChainLength;
+		for (uint8_t display = 0; display < _ChainLength; display++) _ChipStats[display].WritesSuppressed++;
+		return; // every display already holds its value
+	}
+	PackChain(RegisterCode, data, _ChainTxBuffer, _ChainLength);
+	SendTransaction(_ChainTxBuffer, _ChainLength*2);
+}
+
+/*!
+	@brief Write the same value to a register of every display in the cascade in one transaction
+	@param RegisterCode the register to write to
+	@param data The data byte to send to the register of every display
+*/
+void MAX7219_SS_RPI::WriteChainAll(uint8_t RegisterCode, uint8_t data)
+{
+	uint8_t chainData[MAX7219_MAX_DISPLAYS];
+	memset(chainData, data, _ChainLength);
+	WriteChain(RegisterCode, chainData);
+}
+
+/*!
+	@brief Send a frame of digit registers to every display in the cascade
+	@param digits digit register values, [display-1][digit]
+	@param chainLength number of displays in the chain
+	@details Each display latches its own register/data pair of a transaction, so the changed digits
+		of each display are packed side by side: transaction N carries the Nth changed digit of every
+		display, displays with fewer changes get a NOP. The frame costs as many transactions as the most
+		changed digits of any one display, sent as one batch, see CommitFrame.
+		Every transaction still spans the whole chain, shorter ones leave the far displays latching stale data.
+		Only the scanned digits (_NoDigits) are sent, digits past the scan limit are never shown.
+*/
+void MAX7219_SS_RPI::FlushFrame(const uint8_t (*digits)[MAX7219_NUM_DIGITS], uint8_t chainLength)
+{
+	uint8_t dirty[MAX7219_MAX_DISPLAYS][MAX7219_NUM_DIGITS]; // changed digits of each display
+	uint8_t dirtyCount[MAX7219_MAX_DISPLAYS];
+	uint8_t transactions = 0;
+	for (uint8_t display = 0; display < chainLength; display++)
+	{
+		uint8_t count = 0;
+		for (uint8_t digit = 0; digit < _NoDigits; digit++)
 		{
-			for (uint8_t i= 1 ; i <_CurrentDisplayNumber; i++)
+			const uint8_t reg = digit + 1;
+			if (!(_ShadowValid[display] & (1 << reg)) || _ShadowRegisters[display][reg] != digits[display][digit])
 			{
-				HighFreqshiftOut(MAX7219_REG_NOP);
-				HighFreqshiftOut(0x00);
+				dirty[display][count++] = digit;
+			}else
+			{
+				_Stats.WritesSuppressed++;
+				_ChipStats[display].WritesSuppressed++;
 			}
 		}
-		MAX7219_CS_SetHigh;
-	}else
+		dirtyCount[display] = count;
+		if (count > transactions) transactions = count;
+	}
+
+	const uint16_t length = chainLength * 2;
+	for (uint8_t transaction = 0; transaction < transactions; transaction++)
 	{
-		uint8_t TransmitBuffer[_CurrentDisplayNumber*2];
-		TransmitBuffer[0] = RegisterCode;
-		TransmitBuffer[1] = data;
-		if (_CurrentDisplayNumber  > 1)
+		uint8_t *buffer = _ChainTxBuffer + (transaction * length);
+		for (uint8_t display = 0; display < chainLength; display++)
 		{
-			for (uint8_t i= 2 ; i < (_CurrentDisplayNumber*2) ; i++)
+			const uint8_t slot = (chainLength - 1 - display) * 2; // first pair lands in the last display
+			if (transaction < dirtyCount[display])
+			{
+				const uint8_t digit = dirty[display][transaction];
+				const uint8_t reg = digit + 1;
+				buffer[slot] = reg;
+				buffer[slot + 1] = digits[display][digit];
+				_ShadowRegisters[display][reg] = digits[display][digit];
+				_ShadowValid[display] |= (1 << reg);
+				_ChipStats[display].RegisterWrites++;
+				_Stats.RegisterWrites++;
+			}else
 			{
-				TransmitBuffer[i] = 0x00;
+				buffer[slot] = MAX7219_REG_NOP;
+				buffer[slot + 1] = 0x00;
 			}
 		}
-		bcm2835_spi_writenb((char*)TransmitBuffer,sizeof(TransmitBuffer));
+	}
+	if (transactions > 0)
+		SendBatch(_ChainTxBuffer, length, transactions);
+}
+
+/*!
+	@brief Render thread, sends queued frames until StopAsync and the queue is empty
+*/
+void MAX7219_SS_RPI::AsyncThreadLoop(void)
+{
+	Frame_t frame;
+	auto nextSend = std::chrono::steady_clock::now();
+	while (true)
+	{
+		if (!AsyncNextFrame(frame))
+		{
+			if (!_AsyncRunning) break;
+			std::unique_lock<std::mutex> wakeLock(_AsyncWakeMutex);
+			_AsyncWake.wait_for(wakeLock, std::chrono::milliseconds(10), [this]{
+				if (!_AsyncRunning) return true;
+				if (!_AsyncLatest) return !_AsyncQueue.Empty();
+				std::lock_guard<std::mutex> mailboxLock(_MailboxMutex);
+				return _MailboxFull;
+			});
+			continue;
+		}
+		{
+			std::lock_guard<std::mutex> busLock(_BusMutex);
+			FlushFrame(frame.Digits, frame.ChainLength);
+		}
+		const auto now = std::chrono::steady_clock::now();
+		const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count();
+		const uint32_t latencyUs = (uint32_t)((nowNs - frame.TimeStampNs) / 1000);
+		_AsyncLastLatencyUs = latencyUs;
+		if (latencyUs > _AsyncMaxLatencyUs) _AsyncMaxLatencyUs = latencyUs;
+		_AsyncTotalLatencyUs += latencyUs;
+		_AsyncFlushed++;
+
+		if (_AsyncLatest && _AsyncIntervalUs > 0)
+		{
+			// rate limit, newer frames pile up in the mailbox meanwhile
+			nextSend += std::chrono::microseconds(_AsyncIntervalUs);
+			if (nextSend < now) nextSend = now;
+			std::unique_lock<std::mutex> wakeLock(_AsyncWakeMutex);
+			_AsyncWake.wait_until(wakeLock, nextSend, [this]{ return !_AsyncRunning; });
+		}
+	}
+}
+
+/*!
+	@brief Take the next frame to send, from the queue or the latest wins mailbox
+	@param frame destination
+	@return false if there is no frame waiting
+*/
+bool MAX7219_SS_RPI::AsyncNextFrame(Frame_t &frame)
+{
+	if (!_AsyncLatest)
+		return _AsyncQueue.Pop(frame);
+
+	std::lock_guard<std::mutex> mailboxLock(_MailboxMutex);
+	if (!_MailboxFull) return false;
+	frame.ChainLength = _Mailbox.ChainLength;
+	frame.TimeStampNs = _Mailbox.TimeStampNs;
+	memcpy(frame.Digits, _Mailbox.Digits, sizeof(frame.Digits[0]) * _Mailbox.ChainLength);
+	_MailboxFull = false;
+	return true;
+}
+
+/*!
+	@brief Fill a buffer with one chain wide transaction and update the shadow registers
+	@param RegisterCode the register to write to
+	@param data array of ChainLength data bytes, data[0] for display one
+	@param buffer destination, chainLength*2 bytes
+	@param chainLength number of displays in the chain
+	@details The first pair shifted out ends up in the last display of the chain,
+		so the buffer is filled from the end of the chain back to display one.
+*/
+void MAX7219_SS_RPI::PackChain(uint8_t RegisterCode, const uint8_t *data, uint8_t *buffer, uint8_t chainLength)
+{
+	for (uint8_t display = 0; display < chainLength; display++)
+	{
+		const uint8_t slot = (chainLength - 1 - display) * 2;
+		buffer[slot] = RegisterCode;
+		buffer[slot + 1] = data[display];
+		if (RegisterCode != MAX7219_REG_NOP && RegisterCode < MAX7219_NUM_REGISTERS)
+		{
+			_ShadowRegisters[display][RegisterCode] = data[display];
+			_ShadowValid[display] |= (1 << RegisterCode);
+			_ChipStats[display].RegisterWrites++;
+		}
+	}
+	if (RegisterCode != MAX7219_REG_NOP && RegisterCode < MAX7219_NUM_REGISTERS)
+		_Stats.RegisterWrites += chainLength;
+}
+
+/*!
+	@brief Send a buffer to the displays inside one chip select window
+	@param buffer the bytes to send, register/data pairs
+	@param length number of bytes in buffer
+*/
+void MAX7219_SS_RPI::SendTransaction(const uint8_t *buffer, uint16_t length)
+{
+	if (_Capture) _Capture->Write(buffer, length, InstrumentNowNs());
+	const uint64_t startTicks = InstrumentTicks();
+	_Transport->Transfer(buffer, length);
+	const uint64_t ticks = InstrumentTicks() - startTicks;
+	_TransportTicks += ticks;
+	_Stats.BytesSent += length;
+	_Stats.Transactions++;
+	CountChipTraffic(length, 1, ticks);
+}
+
+/*!
+	@brief Send several transactions of the same length, each in its own chip select window
+	@param buffer the transactions back to back, count*length bytes
+	@param length number of bytes in each transaction
+	@param count number of transactions
+*/
+void MAX7219_SS_RPI::SendBatch(const uint8_t *buffer, uint16_t length, uint16_t count)
+{
+	if (_Capture)
+	{
+		const int64_t nowNs = InstrumentNowNs();
+		for (uint16_t i = 0; i < count; i++) _Capture->Write(buffer + (i * length), length, nowNs);
+	}
+	const uint64_t startTicks = InstrumentTicks();
+	_Transport->TransferBatch(buffer, length, count);
+	const uint64_t ticks = InstrumentTicks() - startTicks;
+	_TransportTicks += ticks;
+	_Stats.BytesSent += (uint64_t)length * count;
+	_Stats.Transactions += count;
+	CountChipTraffic(length, count, ticks);
+}
+
+/*!
+	@brief Add transactions to the bus counters of the displays they reach
+	@param length number of bytes in each transaction
+	@param count number of transactions
+	@param ticks transport time of all the transactions
+	@note The first length/2 displays of the chain each latch one register/data pair of every
+		transaction, so each gets 2 bytes and 2/length of the time.
+*/
+void MAX7219_SS_RPI::CountChipTraffic(uint16_t length, uint16_t count, uint64_t ticks)
+{
+	if (length < 2) return;
+	const uint8_t reached = (length / 2 < _ChainLength) ? (uint8_t)(length / 2) : _ChainLength;
+	const uint64_t chipTicks = (ticks * 2) / length;
+	for (uint8_t display = 0; display < reached; display++)
+	{
+		_ChipStats[display].BytesSent += (uint64_t)count * 2;
+		_ChipStats[display].Transactions += count;
+		_ChipTransportTicks[display] += chipTicks;
 	}
 }
 
@@ -542,25 +1686,7 @@ void MAX7219_SS_RPI::SetScanLimit(ScanLimit_e numDigits)
 */
 void MAX7219_SS_RPI::MAX7219SPIHWSettings(void)
 {
-	bcm2835_spi_setBitOrder(BCM2835_SPI_BIT_ORDER_MSBFIRST);
-	bcm2835_spi_setDataMode(BCM2835_SPI_MODE0); 
-	
-	// SPI bus speed
-	if (_KiloHertz > 0)
-		bcm2835_spi_setClockDivider(bcm2835_aux_spi_CalcClockDivider(_KiloHertz));
-	else // default, BCM2835_SPI_CLOCK_DIVIDER_64 3.90MHz Rpi2, 6.250MHz RPI3
-		bcm2835_spi_setClockDivider(BCM2835_SPI_CLOCK_DIVIDER_64); 
-	
-	// Chip enable pin select
-	if (_SPICEX_CS_IO == 0)
-	{
-		bcm2835_spi_chipSelect(BCM2835_SPI_CS0);
-		bcm2835_spi_setChipSelectPolarity(BCM2835_SPI_CS0, LOW);
-	}else if (_SPICEX_CS_IO == 1)
-	{
-		bcm2835_spi_chipSelect(BCM2835_SPI_CS1);
-		bcm2835_spi_setChipSelectPolarity(BCM2835_SPI_CS1, LOW);
-	}
+	_Transport->RefreshSettings();
 }
 
 // == EOF ==
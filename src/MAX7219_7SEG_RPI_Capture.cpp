@@ -0,0 +1,226 @@
+/*!
+	@file MAX7219_7SEG_RPI_Capture.cpp
+	@author Gavin Lyons
+	@brief library source file, capture file of the bus traffic sent to MAX7219 displays
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#include "MAX7219_7SEG_RPI_Capture.hpp"
+#include <string.h>
+
+static const char CaptureMagic[8] = {'M','A','X','7','2','1','9','C'}; /**< First 8 bytes of a capture file */
+
+// MAX7219_CaptureWriter
+
+/*!
+	@brief Destructor, writes buffered records and closes the file
+*/
+MAX7219_CaptureWriter::~MAX7219_CaptureWriter()
+{
+	Close();
+}
+
+/*!
+	@brief Create a capture file and write its header
+	@param path file to create, overwritten if it exists
+	@return false if the file could not be created
+*/
+bool MAX7219_CaptureWriter::Open(const char *path)
+{
+	Close();
+	_File = fopen(path, "wb");
+	if (_File == nullptr) return false;
+	uint8_t header[16] = {};
+	memcpy(header, CaptureMagic, sizeof(CaptureMagic));
+	header[8] = MAX7219_CAPTURE_VERSION & 0xFF;
+	header[9] = MAX7219_CAPTURE_VERSION >> 8;
+	header[10] = MAX7219_CAPTURE_RECORD_SIZE;
+	header[11] = 0;
+	_BufferUsed = 0;
+	_First = true;
+	_TransactionCount = 0;
+	_Error = (fwrite(header, sizeof(header), 1, _File) != 1);
+	return !_Error;
+}
+
+/*!
+	@brief Write buffered records and close the file
+*/
+void MAX7219_CaptureWriter::Close(void)
+{
+	if (_File == nullptr) return;
+	Flush();
+	fclose(_File);
+	_File = nullptr;
+}
+
+/*!
+	@brief Get state of capture file
+	@return true if open
+*/
+bool MAX7219_CaptureWriter::IsOpen(void) {return _File != nullptr;}
+
+/*!
+	@brief Record one transaction
+	@param buffer the bytes sent, register/data pairs, first pair for the farthest display
+	@param length number of bytes in buffer
+	@param timeNs monotonic time the transaction was sent
+*/
+void MAX7219_CaptureWriter::Write(const uint8_t *buffer, uint16_t length, int64_t timeNs)
+{
+	if (_File == nullptr) return;
+	const uint16_t pairs = length / 2;
+	uint32_t deltaUs = 0;
+	if (!_First)
+	{
+		const int64_t delta = (timeNs - _LastTimeNs) / 1000;
+		deltaUs = (delta < 0) ? 0 : (delta > UINT32_MAX) ? UINT32_MAX : (uint32_t)delta;
+	}
+	_First = false;
+	_LastTimeNs = timeNs;
+	AddRecord(deltaUs, (pairs > 0xFF) ? 0xFF : (uint8_t)pairs, 0, 0, MAX7219_CAPTURE_FLAG_TRANSACTION);
+	for (uint16_t pair = 0; pair < pairs && pair < 0xFF; pair++)
+	{
+		const uint8_t reg = buffer[pair * 2];
+		if (reg == 0x00) continue; // NOP
+		AddRecord(0, (uint8_t)(pairs - 1 - pair), reg, buffer[pair * 2 + 1], 0);
+	}
+	_TransactionCount++;
+}
+
+/*!
+	@brief Write buffered records to the file
+	@return false if a write has failed since Open
+*/
+bool MAX7219_CaptureWriter::Flush(void)
+{
+	if (_File == nullptr) return false;
+	if (_BufferUsed > 0 && fwrite(_Buffer, _BufferUsed, 1, _File) != 1) _Error = true;
+	_BufferUsed = 0;
+	fflush(_File);
+	return !_Error;
+}
+
+/*!
+	@brief Get number of transactions written since Open
+	@return transaction count
+*/
+uint32_t MAX7219_CaptureWriter::GetTransactionCount(void) {return _TransactionCount;}
+
+/*!
+	@brief Add one record to the buffer, writing the buffer when it is full
+	@param field time step or 0
+	@param chip display index or pair count
+	@param reg register
+	@param data data
+	@param flags record flags
+*/
+void MAX7219_CaptureWriter::AddRecord(uint32_t field, uint8_t chip, uint8_t reg, uint8_t data, uint8_t flags)
+{
+	if (_BufferUsed == sizeof(_Buffer))
+	{
+		if (fwrite(_Buffer, _BufferUsed, 1, _File) != 1) _Error = true;
+		_BufferUsed = 0;
+	}
+	uint8_t *record = _Buffer + _BufferUsed;
+	record[0] = field & 0xFF;
+	record[1] = (field >> 8) & 0xFF;
+	record[2] = (field >> 16) & 0xFF;
+	record[3] = (field >> 24) & 0xFF;
+	record[4] = chip;
+	record[5] = reg;
+	record[6] = data;
+	record[7] = flags;
+	_BufferUsed += MAX7219_CAPTURE_RECORD_SIZE;
+}
+
+// MAX7219_CaptureReader
+
+/*!
+	@brief Destructor, closes the file
+*/
+MAX7219_CaptureReader::~MAX7219_CaptureReader()
+{
+	Close();
+}
+
+/*!
+	@brief Open a capture file and check its header
+	@param path capture file
+	@return false if the file could not be opened or is not a version 1 capture file
+*/
+bool MAX7219_CaptureReader::Open(const char *path)
+{
+	Close();
+	_File = fopen(path, "rb");
+	if (_File == nullptr) return false;
+	uint8_t header[16];
+	if (fread(header, sizeof(header), 1, _File) != 1 || memcmp(header, CaptureMagic, sizeof(CaptureMagic)) != 0 ||
+		(header[8] | (header[9] << 8)) != MAX7219_CAPTURE_VERSION || header[10] != MAX7219_CAPTURE_RECORD_SIZE)
+	{
+		Close();
+		return false;
+	}
+	_HavePending = false;
+	return true;
+}
+
+/*!
+	@brief Close the file
+*/
+void MAX7219_CaptureReader::Close(void)
+{
+	if (_File == nullptr) return;
+	fclose(_File);
+	_File = nullptr;
+}
+
+/*!
+	@brief Read the next transaction, rebuilt with NOP pairs
+	@param buffer destination for the transaction bytes
+	@param bufferSize size of buffer
+	@param length output, number of bytes in the transaction
+	@param deltaUs output, uS since the previous transaction was sent
+	@return false at end of file, or if the transaction does not fit in buffer
+*/
+bool MAX7219_CaptureReader::Next(uint8_t *buffer, uint16_t bufferSize, uint16_t &length, uint32_t &deltaUs)
+{
+	if (_File == nullptr) return false;
+	uint8_t record[MAX7219_CAPTURE_RECORD_SIZE];
+	if (_HavePending)
+	{
+		memcpy(record, _Pending, sizeof(record));
+		_HavePending = false;
+	}else
+	{
+		do
+		{
+			if (fread(record, sizeof(record), 1, _File) != 1) return false;
+		} while (!(record[7] & MAX7219_CAPTURE_FLAG_TRANSACTION)); // skip stray pairs
+	}
+
+	const uint8_t pairs = record[4];
+	deltaUs = record[0] | (record[1] << 8) | (record[2] << 16) | ((uint32_t)record[3] << 24);
+	length = pairs * 2;
+	if (length > bufferSize) return false;
+	memset(buffer, 0, length);
+
+	while (fread(record, sizeof(record), 1, _File) == 1)
+	{
+		if (record[7] & MAX7219_CAPTURE_FLAG_TRANSACTION)
+		{
+			memcpy(_Pending, record, sizeof(record));
+			_HavePending = true;
+			break;
+		}
+		const uint8_t chip = record[4];
+		if (chip >= pairs) continue;
+		const uint16_t slot = (pairs - 1 - chip) * 2;
+		buffer[slot] = record[5];
+		buffer[slot + 1] = record[6];
+	}
+	return true;
+}
+
+// == EOF ==
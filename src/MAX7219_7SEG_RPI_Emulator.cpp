@@ -0,0 +1,231 @@
+/*!
+	@file MAX7219_7SEG_RPI_Emulator.cpp
+	@author Gavin Lyons
+	@brief library source file, software emulator of a daisy chain of MAX7219 chips
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#include "MAX7219_7SEG_RPI_Emulator.hpp"
+
+// MAX7219 register addresses
+#define EMU_REG_DECODE    0x09 /**< Decode mode register */
+#define EMU_REG_INTENSITY 0x0A /**< Intensity register */
+#define EMU_REG_SCANLIMIT 0x0B /**< Scan limit register */
+#define EMU_REG_SHUTDOWN  0x0C /**< Shutdown register */
+#define EMU_REG_TEST      0x0F /**< Display test register */
+
+/*!
+	@brief Constructor for emulator
+	@param chainLength number of chips in the chain, at least 1
+*/
+MAX7219_Emulator::MAX7219_Emulator(uint8_t chainLength)
+{
+	_Chips.resize(chainLength > 0 ? chainLength : 1);
+	Reset();
+}
+
+/*!
+	@brief Start the emulator, nothing to do
+	@return always true
+*/
+bool MAX7219_Emulator::Begin(void) {return true;}
+
+/*!
+	@brief End the emulator, nothing to do
+*/
+void MAX7219_Emulator::End(void) {}
+
+/*!
+	@brief Power on state, all registers 0 (shutdown, no decode, scan limit digit 0), shift registers empty
+*/
+void MAX7219_Emulator::Reset(void)
+{
+	for (Chip_t &chip : _Chips) chip = Chip_t{};
+	_ChipSelect = true;
+	_Clock = false;
+	_LatchCount = 0;
+}
+
+/*!
+	@brief Clock one transaction in bit by bit, MSB first, inside one CS window
+	@param buffer the bytes sent
+	@param length number of bytes in buffer
+*/
+void MAX7219_Emulator::Transfer(const uint8_t *buffer, uint16_t length)
+{
+	Edge(false, false, false);
+	for (uint16_t i = 0; i < length; i++)
+	{
+		for (uint8_t bitMask = 0x80; bitMask; bitMask >>= 1)
+		{
+			const bool bit = buffer[i] & bitMask;
+			Edge(false, false, bit);
+			Edge(false, true, bit);
+		}
+	}
+	Edge(false, false, false);
+	Edge(true, false, false);
+}
+
+/*!
+	@brief Apply new pin levels, acts on CLK and CS rising edges
+	@param chipSelect CS (LOAD) level
+	@param clock CLK level
+	@param data DIN level
+	@note As on the MAX7219, data is shifted on CLK rising edges whatever the level of CS
+*/
+void MAX7219_Emulator::Edge(bool chipSelect, bool clock, bool data)
+{
+	if (clock && !_Clock) ShiftIn(data);
+	if (chipSelect && !_ChipSelect) Latch();
+	_Clock = clock;
+	_ChipSelect = chipSelect;
+}
+
+/*!
+	@brief Apply GPIO states recorded by MAX7219_GpioPortRecorder
+	@param states state of GPIO 0-31 after each write
+	@param clock CLK GPIO
+	@param chipSelect CS GPIO
+	@param data DIN GPIO of this chain
+*/
+void MAX7219_Emulator::FeedGpioStates(const std::vector<uint32_t> &states, uint8_t clock, uint8_t chipSelect, uint8_t data)
+{
+	for (const uint32_t state : states)
+	{
+		Edge(state & (1u << chipSelect), state & (1u << clock), state & (1u << data));
+	}
+}
+
+/*!
+	@brief Get number of chips
+	@return chain length
+*/
+uint8_t MAX7219_Emulator::GetChainLength(void) {return (uint8_t)_Chips.size();}
+
+/*!
+	@brief Get a latched register of a chip
+	@param chip chip index, 0 = display one
+	@param reg register address 0-15
+	@return register value, 0 if chip or reg not valid
+*/
+uint8_t MAX7219_Emulator::GetRegister(uint8_t chip, uint8_t reg)
+{
+	return (chip < _Chips.size() && reg < 16) ? _Chips[chip].Registers[reg] : 0;
+}
+
+/*!
+	@brief Get the shift register of a chip, not yet latched data
+	@param chip chip index, 0 = display one
+	@return 16 bit shift register
+*/
+uint16_t MAX7219_Emulator::GetShiftRegister(uint8_t chip)
+{
+	return (chip < _Chips.size()) ? _Chips[chip].Shift : 0;
+}
+
+/*!
+	@brief Get DOUT of the last chip of the chain
+	@return level of the bit that would be shifted into a further chip
+*/
+bool MAX7219_Emulator::GetDout(void) {return _Chips.back().Shift & 0x8000;}
+
+/*!
+	@brief Get number of CS rising edges, i.e. transactions latched
+	@return latch count since Reset
+*/
+uint32_t MAX7219_Emulator::GetLatchCount(void) {return _LatchCount;}
+
+/*!
+	@brief Get the segments lit on one digit, as the chip would drive them
+	@param chip chip index, 0 = display one
+	@param digit digit 0-7, 0 = register 1 = right hand digit
+	@return segments dpabcdefg, decode, scan limit, shutdown and test mode applied
+*/
+uint8_t MAX7219_Emulator::GetSegments(uint8_t chip, uint8_t digit)
+{
+	if (chip >= _Chips.size() || digit > 7) return 0;
+	const uint8_t *registers = _Chips[chip].Registers;
+	if (registers[EMU_REG_TEST] & 0x01) return 0xFF; // test mode overrides shutdown
+	if (!(registers[EMU_REG_SHUTDOWN] & 0x01)) return 0x00;
+	if (digit > (registers[EMU_REG_SCANLIMIT] & 0x07)) return 0x00;
+	const uint8_t value = registers[digit + 1];
+	if (registers[EMU_REG_DECODE] & (1 << digit)) return (value & 0x80) | CodeB(value & 0x0F);
+	return value;
+}
+
+/*!
+	@brief Draw the chain as seven segment ASCII art, three lines
+	@return the drawing, display one on the left, each display left hand digit first, a space between displays
+*/
+std::string MAX7219_Emulator::Render(void)
+{
+	std::string lines[3];
+	for (uint8_t chip = 0; chip < _Chips.size(); chip++)
+	{
+		if (chip > 0) for (std::string &line : lines) line += ' ';
+		for (int8_t digit = 7; digit >= 0; digit--)
+		{
+			const uint8_t segments = GetSegments(chip, digit);
+			// bit 7 dp, 6 a, 5 b, 4 c, 3 d, 2 e, 1 f, 0 g
+			lines[0] += ' ';
+			lines[0] += (segments & 0x40) ? '_' : ' ';
+			lines[0] += "  ";
+			lines[1] += (segments & 0x02) ? '|' : ' ';
+			lines[1] += (segments & 0x01) ? '_' : ' ';
+			lines[1] += (segments & 0x20) ? '|' : ' ';
+			lines[1] += ' ';
+			lines[2] += (segments & 0x04) ? '|' : ' ';
+			lines[2] += (segments & 0x08) ? '_' : ' ';
+			lines[2] += (segments & 0x10) ? '|' : ' ';
+			lines[2] += (segments & 0x80) ? '.' : ' ';
+		}
+	}
+	return lines[0] + "\n" + lines[1] + "\n" + lines[2] + "\n";
+}
+
+/*!
+	@brief Shift one bit into the chain, each chip passes its MSB on to the next chip
+	@param data DIN level
+*/
+void MAX7219_Emulator::ShiftIn(bool data)
+{
+	bool carry = data;
+	for (Chip_t &chip : _Chips)
+	{
+		const bool out = chip.Shift & 0x8000;
+		chip.Shift = (uint16_t)((chip.Shift << 1) | carry);
+		carry = out;
+	}
+}
+
+/*!
+	@brief CS rising edge, every chip latches its shift register, D11-D8 address and D7-D0 data
+*/
+void MAX7219_Emulator::Latch(void)
+{
+	for (Chip_t &chip : _Chips)
+	{
+		const uint8_t reg = (chip.Shift >> 8) & 0x0F;
+		if (reg != 0x00) chip.Registers[reg] = chip.Shift & 0xFF; // 0 = no-op
+	}
+	_LatchCount++;
+}
+
+/*!
+	@brief Code B font of the MAX7219
+	@param value 0-15
+	@return segments abcdefg, 0-9, -, E, H, L, P, blank
+*/
+uint8_t MAX7219_Emulator::CodeB(uint8_t value)
+{
+	static const uint8_t font[16] =
+	{
+		0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x5F, 0x70,
+		0x7F, 0x7B, 0x01, 0x4F, 0x37, 0x0E, 0x67, 0x00
+	};
+	return font[value & 0x0F];
+}
+
+// == EOF ==
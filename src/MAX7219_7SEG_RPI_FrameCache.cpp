@@ -0,0 +1,150 @@
+/*!
+	@file MAX7219_7SEG_RPI_FrameCache.cpp
+	@author Gavin Lyons
+	@brief library source file, cache of prebuilt frames for MAX7219 displays
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#include "MAX7219_7SEG_RPI_FrameCache.hpp"
+#include <string.h>
+#include <algorithm>
+
+/*!
+	@brief Constructor for frame cache
+	@param capacity number of entries, at least 1
+	@param entrySize bytes per entry
+	@param keySize largest key in bytes, longer keys are not cached
+*/
+MAX7219_FrameCache::MAX7219_FrameCache(uint16_t capacity, uint16_t entrySize, uint16_t keySize) :
+	_Capacity(capacity > 0 ? capacity : 1), _EntrySize(entrySize), _KeySize(keySize)
+{
+	_Hashes.resize(_Capacity);
+	_KeyLengths.resize(_Capacity);
+	_KeyStorage.resize((size_t)_Capacity * _KeySize);
+	_LastUse.resize(_Capacity);
+	_Storage.resize((size_t)_Capacity * _EntrySize);
+	uint32_t buckets = 1;
+	while (buckets < 2u * _Capacity) buckets <<= 1;
+	_Buckets.assign(buckets, -1);
+	_Next.assign(_Capacity, -1);
+	_BucketMask = buckets - 1;
+	_Stats.Capacity = _Capacity;
+}
+
+/*!
+	@brief Look up a frame and mark it as used, counted as a hit or a miss
+	@param hash hash of the key, see Hash
+	@param key bytes that decide the frame
+	@param length size of key in bytes
+	@return index of the entry, -1 if not in the cache
+*/
+int32_t MAX7219_FrameCache::Find(uint64_t hash, const void *key, size_t length)
+{
+	for (int32_t index = _Buckets[hash & _BucketMask]; index >= 0; index = _Next[index])
+	{
+		if (_Hashes[index] != hash) continue;
+		if (_KeyLengths[index] != length ||
+			memcmp(_KeyStorage.data() + ((size_t)index * _KeySize), key, length) != 0)
+		{
+			_Stats.Collisions++; // same hash, other key, keep looking
+			continue;
+		}
+		_LastUse[index] = ++_UseCount;
+		_Stats.Hits++;
+		return index;
+	}
+	_Stats.Misses++;
+	return -1;
+}
+
+/*!
+	@brief Take an entry for a new frame, the least recently used entry is evicted if the cache is full
+	@param hash hash of the key, see Hash
+	@param key bytes that decide the frame, must not be in the cache already, see Find
+	@param length size of key in bytes
+	@return index of the entry, fill it with GetEntry. -1 if the key is longer than keySize
+*/
+int32_t MAX7219_FrameCache::Insert(uint64_t hash, const void *key, size_t length)
+{
+	if (length > _KeySize) return -1;
+	uint16_t slot = 0;
+	if (_Entries < _Capacity)
+	{
+		slot = _Entries++;
+	}else
+	{
+		for (uint16_t index = 1; index < _Capacity; index++)
+		{
+			if (_LastUse[index] < _LastUse[slot]) slot = index;
+		}
+		Unlink(slot);
+		_Stats.Evictions++;
+	}
+	const uint32_t bucket = hash & _BucketMask;
+	_Next[slot] = _Buckets[bucket];
+	_Buckets[bucket] = slot;
+	_Hashes[slot] = hash;
+	_KeyLengths[slot] = (uint16_t)length;
+	memcpy(_KeyStorage.data() + ((size_t)slot * _KeySize), key, length);
+	_LastUse[slot] = ++_UseCount;
+	_Stats.Entries = _Entries;
+	return slot;
+}
+
+/*!
+	@brief Get the data of an entry
+	@param index entry from Find or Insert
+	@return pointer to entrySize bytes
+*/
+uint8_t *MAX7219_FrameCache::GetEntry(int32_t index)
+{
+	return _Storage.data() + ((size_t)index * _EntrySize);
+}
+
+/*!
+	@brief Remove every entry, statistics are kept
+*/
+void MAX7219_FrameCache::Clear(void)
+{
+	_Entries = 0;
+	_Stats.Entries = 0;
+	std::fill(_Buckets.begin(), _Buckets.end(), -1);
+}
+
+/*!
+	@brief Take an entry out of its bucket before it is reused
+	@param slot entry index
+*/
+void MAX7219_FrameCache::Unlink(uint16_t slot)
+{
+	int32_t *link = &_Buckets[_Hashes[slot] & _BucketMask];
+	while (*link >= 0 && *link != slot) link = &_Next[*link];
+	if (*link == slot) *link = _Next[slot];
+}
+
+/*!
+	@brief Get statistics of the cache
+	@param stats filled with hits, misses, evictions, collisions and entries in use
+*/
+void MAX7219_FrameCache::GetStats(Stats_t &stats) {stats = _Stats;}
+
+/*!
+	@brief FNV-1a hash, chain calls by passing the previous result as hash
+	@param data bytes to hash
+	@param length number of bytes
+	@param hash starting value, HashSeed for a new hash
+	@return 64 bit hash
+*/
+uint64_t MAX7219_FrameCache::Hash(const void *data, size_t length, uint64_t hash)
+{
+	const uint8_t *bytes = static_cast<const uint8_t *>(data);
+	for (size_t index = 0; index < length; index++)
+	{
+		hash ^= bytes[index];
+		hash *= 0x100000001B3ULL; // FNV-1a 64 bit prime
+	}
+	return hash;
+}
+
+// == EOF ==
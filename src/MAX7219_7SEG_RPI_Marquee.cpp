@@ -0,0 +1,223 @@
+/*!
+	@file MAX7219_7SEG_RPI_Marquee.cpp
+	@author Gavin Lyons
+	@brief library source file, scrolls text across one or more MAX7219 displays
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#include "MAX7219_7SEG_RPI_Marquee.hpp"
+#include <chrono>
+
+/*!
+	@brief Constructor for marquee
+	@param display display object of the chain, owned by the caller, displays must be initialised
+*/
+MAX7219_Marquee::MAX7219_Marquee(MAX7219_SS_RPI *display)
+{
+	_Display = display;
+}
+
+/*!
+	@brief Set the message to scroll and restart scrolling
+	@param text the message, a '.' following a character sets the decimal point of that character
+*/
+void MAX7219_Marquee::SetMessage(std::string_view text)
+{
+	const uint16_t width = (text.length() > UINT16_MAX) ? UINT16_MAX : (uint16_t)text.length();
+	_Segments.resize(width);
+	uint16_t first = 0;
+	const uint16_t count = MAX7219_SS_RPI::LayoutText(text.data(), text.length(),
+		MAX7219_SS_RPI::AlignLeft, _Segments.data(), width, first);
+	_Segments.resize(count);
+	Reset();
+}
+
+/*!
+	@brief Set the displays the message scrolls across
+	@param firstDisplay left hand display of the window, 1 to MAX7219_MAX_DISPLAYS
+	@param displayCount number of cascaded displays in the window, the window is
+		firstDisplay to firstDisplay + displayCount - 1
+*/
+void MAX7219_Marquee::SetDisplays(uint8_t firstDisplay, uint8_t displayCount)
+{
+	if (firstDisplay < 1) firstDisplay = 1;
+	if (firstDisplay > MAX7219_MAX_DISPLAYS) firstDisplay = MAX7219_MAX_DISPLAYS;
+	if (displayCount < 1) displayCount = 1;
+	if (firstDisplay + displayCount - 1 > MAX7219_MAX_DISPLAYS) displayCount = MAX7219_MAX_DISPLAYS - firstDisplay + 1;
+	_FirstDisplay = firstDisplay;
+	_DisplayCount = displayCount;
+	Reset();
+}
+
+/*!
+	@brief Set the scroll direction and restart scrolling
+	@param mode left, right or bounce
+*/
+void MAX7219_Marquee::SetMode(ScrollMode_e mode)
+{
+	_Mode = mode;
+	Reset();
+}
+
+/*!
+	@brief Get the scroll direction
+	@return left, right or bounce
+*/
+MAX7219_Marquee::ScrollMode_e MAX7219_Marquee::GetMode(void) {return _Mode;}
+
+/*!
+	@brief Set the time between steps made by Update
+	@param intervalMs milliseconds per step
+*/
+void MAX7219_Marquee::SetStepInterval(uint32_t intervalMs) {_StepIntervalMs = intervalMs;}
+
+/*!
+	@brief Get the time between steps made by Update
+	@return milliseconds per step
+*/
+uint32_t MAX7219_Marquee::GetStepInterval(void) {return _StepIntervalMs;}
+
+/*!
+	@brief Get the number of digits in the window
+	@return displayCount times digits per display
+*/
+uint16_t MAX7219_Marquee::GetWindowWidth(void)
+{
+	return _DisplayCount * _Display->GetNumDigits();
+}
+
+/*!
+	@brief Get the number of completed scroll cycles since the message was set
+	@return cycles, a cycle ends when the message has fully passed (left, right)
+		or is back at the start (bounce)
+*/
+uint32_t MAX7219_Marquee::GetCycleCount(void) {return _CycleCount;}
+
+/*!
+	@brief Move the window back to the start of a cycle, nothing is sent
+	@details Left starts with a blank window, right with a blank window,
+		bounce with the message left aligned.
+*/
+void MAX7219_Marquee::Reset(void)
+{
+	const int32_t width = GetWindowWidth();
+	const int32_t length = (int32_t)_Segments.size();
+	switch (_Mode)
+	{
+		case ScrollLeft:  _Position = -width; break;
+		case ScrollRight: _Position = length; break;
+		case ScrollBounce:
+			_Position = 0;
+			_Direction = (length < width) ? -1 : 1;
+		break;
+	}
+	_CycleCount = 0;
+	_Started = false;
+}
+
+/*!
+	@brief Move the window one digit and draw it
+*/
+void MAX7219_Marquee::Step(void)
+{
+	const int32_t width = GetWindowWidth();
+	const int32_t length = (int32_t)_Segments.size();
+	switch (_Mode)
+	{
+		case ScrollLeft:
+			if (++_Position >= length)
+			{
+				_Position = -width;
+				_CycleCount++;
+			}
+		break;
+		case ScrollRight:
+			if (--_Position <= -width)
+			{
+				_Position = length;
+				_CycleCount++;
+			}
+		break;
+		case ScrollBounce:
+		{
+			const int32_t low = (length < width) ? length - width : 0;
+			const int32_t high = (length < width) ? 0 : length - width;
+			if (low == high) break;
+			_Position += _Direction;
+			if (_Position <= low) {_Position = low; _Direction = 1;}
+			if (_Position >= high) {_Position = high; _Direction = -1;}
+			if (_Position == 0) _CycleCount++;
+		}
+		break;
+	}
+	Draw();
+}
+
+/*!
+	@brief Write the window at its current position to the displays
+	@note In frame buffered mode the frame is committed. The current display number is restored.
+*/
+void MAX7219_Marquee::Draw(void)
+{
+	const uint8_t digits = _Display->GetNumDigits();
+	const uint8_t currentDisplay = _Display->GetCurrentDisplayNumber();
+	int32_t index = _Position;
+	for (uint8_t display = 0; display < _DisplayCount; display++)
+	{
+		_Display->SetCurrentDisplayNumber(_FirstDisplay + display);
+		for (uint8_t digit = digits; digit > 0; digit--) // left hand digit first
+		{
+			_Display->SetSegment(digit - 1, SegmentAt(index++));
+		}
+	}
+	_Display->SetCurrentDisplayNumber(currentDisplay);
+	if (_Display->GetFrameBuffered()) _Display->CommitFrame();
+}
+
+/*!
+	@brief Draw the first window or make a step if the step interval has passed
+	@return true if the displays were written
+	@note Call often from the application loop. Uses the steady clock, see also Update(uint64_t)
+*/
+bool MAX7219_Marquee::Update(void)
+{
+	const uint64_t nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+	return Update(nowMs);
+}
+
+/*!
+	@brief Draw the first window or make a step if the step interval has passed
+	@param nowMs current time in milliseconds from any monotonic clock
+	@return true if the displays were written
+	@note Steps are spaced from the time of the first Update, if the caller falls behind
+		by more than one interval the missed steps are skipped rather than made in a burst.
+*/
+bool MAX7219_Marquee::Update(uint64_t nowMs)
+{
+	if (!_Started)
+	{
+		_Started = true;
+		_LastStepMs = nowMs;
+		Draw();
+		return true;
+	}
+	if (nowMs - _LastStepMs < _StepIntervalMs) return false;
+	_LastStepMs += _StepIntervalMs;
+	if (nowMs - _LastStepMs >= _StepIntervalMs) _LastStepMs = nowMs;
+	Step();
+	return true;
+}
+
+/*!
+	@brief Get the seven segment code of the message at an index
+	@param index index in the message, outside the message is blank
+	@return seven segment code
+*/
+uint8_t MAX7219_Marquee::SegmentAt(int32_t index)
+{
+	return (index >= 0 && index < (int32_t)_Segments.size()) ? _Segments[index] : 0x00;
+}
+
+// == EOF ==
@@ -0,0 +1,189 @@
+/*!
+	@file MAX7219_7SEG_RPI_MultiBus.cpp
+	@author Gavin Lyons
+	@brief library source file, drives several independent chains of MAX7219 displays in parallel
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#include "MAX7219_7SEG_RPI_MultiBus.hpp"
+#include <chrono>
+
+/*!
+	@brief Steady clock time in nanoseconds
+	@return nanoseconds since an arbitrary start
+*/
+static int64_t MultiBusNowNs(void)
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/*!
+	@brief Destructor, stops the worker threads
+*/
+MAX7219_MultiBus::~MAX7219_MultiBus()
+{
+	Stop();
+}
+
+/*!
+	@brief Add a chain of displays
+	@param display the chain, owned by the caller. Its frame buffered mode is turned on.
+	@return index of the chain, -1 if MAX7219_MAX_CHAINS reached or the workers are running
+	@note Init the displays of the chain with InitDisplay before calling Start.
+*/
+int8_t MAX7219_MultiBus::AddChain(MAX7219_SS_RPI *display)
+{
+	if (_Running || display == nullptr || _ChainCount >= MAX7219_MAX_CHAINS) return -1;
+	display->SetFrameBuffered(true);
+	_Workers[_ChainCount].Display = display;
+	return _ChainCount++;
+}
+
+/*!
+	@brief Get the number of chains added
+	@return number of chains
+*/
+uint8_t MAX7219_MultiBus::GetChainCount(void) {return _ChainCount;}
+
+/*!
+	@brief Get a chain to write its frame
+	@param index chain index returned by AddChain
+	@return the chain, nullptr if index is not valid
+	@note Do not write to a chain between Dispatch and Wait
+*/
+MAX7219_SS_RPI* MAX7219_MultiBus::GetChain(uint8_t index)
+{
+	return (index < _ChainCount) ? _Workers[index].Display : nullptr;
+}
+
+/*!
+	@brief Start one worker thread per chain
+	@return true if started, false if already running or no chains added
+*/
+bool MAX7219_MultiBus::Start(void)
+{
+	if (_Running || _ChainCount == 0) return false;
+	_Running = true;
+	_Generation = 0;
+	_Pending = 0;
+	_Dispatched = false;
+	for (uint8_t index = 0; index < _ChainCount; index++)
+	{
+		_Workers[index].Thread = std::thread(&MAX7219_MultiBus::WorkerLoop, this, index);
+	}
+	return true;
+}
+
+/*!
+	@brief Wait for any commit in progress and stop the worker threads
+*/
+void MAX7219_MultiBus::Stop(void)
+{
+	if (!_Running) return;
+	Wait();
+	{
+		std::lock_guard<std::mutex> lock(_Mutex);
+		_Running = false;
+	}
+	_WorkCV.notify_all();
+	for (uint8_t index = 0; index < _ChainCount; index++)
+	{
+		if (_Workers[index].Thread.joinable()) _Workers[index].Thread.join();
+	}
+}
+
+/*!
+	@brief get state of worker threads
+	@return true if running, see Start
+*/
+bool MAX7219_MultiBus::GetRunning(void) {return _Running;}
+
+/*!
+	@brief Start committing the frame of every chain in parallel and return at once
+	@note Call Wait before writing to the chains again. Does nothing if not started
+		or a dispatch is already in progress.
+*/
+void MAX7219_MultiBus::Dispatch(void)
+{
+	{
+		std::lock_guard<std::mutex> lock(_Mutex);
+		if (!_Running || _Dispatched) return;
+		_Dispatched = true;
+		_Pending = _ChainCount;
+		_DispatchNs = MultiBusNowNs();
+		_Generation++;
+	}
+	_WorkCV.notify_all();
+}
+
+/*!
+	@brief Wait until every chain has finished the commit started by Dispatch
+*/
+void MAX7219_MultiBus::Wait(void)
+{
+	std::unique_lock<std::mutex> lock(_Mutex);
+	if (!_Dispatched) return;
+	_DoneCV.wait(lock, [this]{ return _Pending == 0; });
+	_Dispatched = false;
+	_LastCommitNs = MultiBusNowNs() - _DispatchNs;
+}
+
+/*!
+	@brief Commit the frame of every chain in parallel and wait for all of them
+*/
+void MAX7219_MultiBus::CommitAll(void)
+{
+	Dispatch();
+	Wait();
+}
+
+/*!
+	@brief Get wall clock time of last commit of all chains
+	@return nanoseconds from Dispatch to the last chain finishing
+*/
+int64_t MAX7219_MultiBus::GetLastCommitNs(void)
+{
+	std::lock_guard<std::mutex> lock(_Mutex);
+	return _LastCommitNs;
+}
+
+/*!
+	@brief Get time one chain took for its last commit
+	@param index chain index returned by AddChain
+	@return nanoseconds, 0 if index is not valid
+*/
+int64_t MAX7219_MultiBus::GetChainCommitNs(uint8_t index)
+{
+	std::lock_guard<std::mutex> lock(_Mutex);
+	return (index < _ChainCount) ? _Workers[index].CommitNs : 0;
+}
+
+/*!
+	@brief Worker thread, commits its chain once per Dispatch
+	@param index chain index
+*/
+void MAX7219_MultiBus::WorkerLoop(uint8_t index)
+{
+	uint32_t seenGeneration = 0;
+	while (true)
+	{
+		{
+			std::unique_lock<std::mutex> lock(_Mutex);
+			_WorkCV.wait(lock, [&]{ return !_Running || _Generation != seenGeneration; });
+			if (!_Running) return;
+			seenGeneration = _Generation;
+		}
+		const int64_t startNs = MultiBusNowNs();
+		_Workers[index].Display->CommitFrame();
+		const int64_t commitNs = MultiBusNowNs() - startNs;
+		{
+			std::lock_guard<std::mutex> lock(_Mutex);
+			_Workers[index].CommitNs = commitNs;
+			if (--_Pending == 0) _DoneCV.notify_all();
+		}
+	}
+}
+
+// == EOF ==
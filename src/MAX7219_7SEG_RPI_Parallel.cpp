@@ -0,0 +1,352 @@
+/*!
+	@file MAX7219_7SEG_RPI_Parallel.cpp
+	@author Gavin Lyons
+	@brief library source file, bit sliced software SPI driving several chains on a shared clock
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#include "MAX7219_7SEG_RPI_Parallel.hpp"
+#include <sys/mman.h>
+
+#ifndef MAX7219_NO_BCM2835
+
+// MAX7219_GpioPortBCM2835
+
+/*!
+	@brief Make GPIO outputs and map GPSET0/GPCLR0/GPLEV0
+	@param outputMask bit mask of GPIO 0-31 to make outputs
+	@return false if the GPIO registers are not mapped, call bcm2835_init first
+*/
+bool MAX7219_GpioPortBCM2835::Begin(uint32_t outputMask)
+{
+	volatile uint32_t *gpio = bcm2835_regbase(BCM2835_REGBASE_GPIO);
+	if (gpio == nullptr || gpio == (uint32_t*)MAP_FAILED) return false;
+	_GpioSet = gpio + BCM2835_GPSET0/4;
+	_GpioClr = gpio + BCM2835_GPCLR0/4;
+	_GpioLev = gpio + BCM2835_GPLEV0/4;
+	for (uint8_t pin = 0; pin < 32; pin++)
+	{
+		if (outputMask & (1u << pin)) bcm2835_gpio_fsel(pin, BCM2835_GPIO_FSEL_OUTP);
+	}
+	return true;
+}
+
+/*!
+	@brief Set GPIO high
+	@param mask bit mask of GPIO
+*/
+void MAX7219_GpioPortBCM2835::Set(uint32_t mask) {bcm2835_peri_write_nb(_GpioSet, mask);}
+
+/*!
+	@brief Set GPIO low
+	@param mask bit mask of GPIO
+*/
+void MAX7219_GpioPortBCM2835::Clear(uint32_t mask) {bcm2835_peri_write_nb(_GpioClr, mask);}
+
+/*!
+	@brief Hold the GPIO levels written last, see MAX7219_GpioEdgeHold
+*/
+void MAX7219_GpioPortBCM2835::Hold(void) {MAX7219_GpioEdgeHold(_GpioLev);}
+
+#endif // MAX7219_NO_BCM2835
+
+// MAX7219_GpioPortRecorder
+
+/*!
+	@brief Start the recorder, all GPIO low
+	@param outputMask not used
+	@return always true
+*/
+bool MAX7219_GpioPortRecorder::Begin(uint32_t outputMask)
+{
+	(void)outputMask;
+	_State = 0;
+	return true;
+}
+
+/*!
+	@brief Set GPIO high and record the new state
+	@param mask bit mask of GPIO
+*/
+void MAX7219_GpioPortRecorder::Set(uint32_t mask)
+{
+	_State |= mask;
+	_States.push_back(_State);
+}
+
+/*!
+	@brief Set GPIO low and record the new state
+	@param mask bit mask of GPIO
+*/
+void MAX7219_GpioPortRecorder::Clear(uint32_t mask)
+{
+	_State &= ~mask;
+	_States.push_back(_State);
+}
+
+/*!
+	@brief Record a hold, the number of states written so far
+*/
+void MAX7219_GpioPortRecorder::Hold(void) {_Holds.push_back(_States.size());}
+
+/*!
+	@brief Forget the recorded states and holds, the current state is kept
+*/
+void MAX7219_GpioPortRecorder::ResetRecord(void)
+{
+	_States.clear();
+	_Holds.clear();
+}
+
+/*!
+	@brief Get the state of all GPIO after every write
+	@return reference to the recorded states
+*/
+const std::vector<uint32_t>& MAX7219_GpioPortRecorder::GetStates(void) {return _States;}
+
+/*!
+	@brief Get the holds, each is the number of states recorded when it was made
+	@return reference to the recorded holds
+*/
+const std::vector<size_t>& MAX7219_GpioPortRecorder::GetHolds(void) {return _Holds;}
+
+/*!
+	@brief Decode the recorded states into the transactions a MAX7219 chain on one DIN pin receives
+	@param clock CLK GPIO
+	@param chipSelect CS GPIO
+	@param data DIN GPIO
+	@param bytes the bytes of each transaction back to back are appended here
+	@param lengths the length of each transaction is appended here
+	@note DIN is sampled on each CLK rising edge while CS is low, CS rising ends a transaction.
+		Bits of an unfinished byte are discarded.
+*/
+void MAX7219_GpioPortRecorder::Decode(uint8_t clock, uint8_t chipSelect, uint8_t data,
+	std::vector<uint8_t> &bytes, std::vector<uint16_t> &lengths)
+{
+	const uint32_t clkMask = 1u << clock;
+	const uint32_t csMask = 1u << chipSelect;
+	const uint32_t dinMask = 1u << data;
+	uint32_t previous = csMask;
+	uint16_t length = 0;
+	uint8_t value = 0;
+	uint8_t bitCount = 0;
+
+	for (const uint32_t state : _States)
+	{
+		if ((previous & csMask) && !(state & csMask)) // CS falling, start of transaction
+		{
+			length = 0;
+			bitCount = 0;
+		}
+		if (!(state & csMask) && !(previous & clkMask) && (state & clkMask)) // CLK rising
+		{
+			value = (uint8_t)((value << 1) | ((state & dinMask) ? 1 : 0));
+			if (++bitCount == 8)
+			{
+				bytes.push_back(value);
+				length++;
+				bitCount = 0;
+			}
+		}
+		if (!(previous & csMask) && (state & csMask)) // CS rising, data latched
+		{
+			lengths.push_back(length);
+		}
+		previous = state;
+	}
+}
+
+// MAX7219_ParallelLane
+
+/*!
+	@brief Start the parallel bus this lane belongs to
+	@return true if successful
+*/
+bool MAX7219_ParallelLane::Begin(void)
+{
+	return (_Owner != nullptr) && _Owner->Begin();
+}
+
+/*!
+	@brief End the parallel bus this lane belongs to
+*/
+void MAX7219_ParallelLane::End(void)
+{
+	if (_Owner != nullptr) _Owner->End();
+}
+
+/*!
+	@brief Queue one transaction, sent by MAX7219_ParallelSWSPI::Flush
+	@param buffer the bytes to send
+	@param length number of bytes in buffer
+*/
+void MAX7219_ParallelLane::Transfer(const uint8_t *buffer, uint16_t length)
+{
+	_Bytes.insert(_Bytes.end(), buffer, buffer + length);
+	_Lengths.push_back(length);
+}
+
+// MAX7219_ParallelSWSPI
+
+/*!
+	@brief Constructor for parallel software SPI
+	@param port GPIO port to write, owned by the caller
+	@param clock shared CLK GPIO
+	@param chipSelect shared CS GPIO
+	@param dataPins DIN GPIO of each chain, laneCount entries
+	@param laneCount number of chains, 1 to MAX7219_MAX_LANES
+	@note If a GPIO is above 31 or used twice GetLaneCount returns 0 and Begin fails.
+*/
+MAX7219_ParallelSWSPI::MAX7219_ParallelSWSPI(MAX7219_GpioPort *port, uint8_t clock, uint8_t chipSelect,
+	const uint8_t *dataPins, uint8_t laneCount)
+{
+	_Port = port;
+	if (port == nullptr || dataPins == nullptr || laneCount == 0 || laneCount > MAX7219_MAX_LANES) return;
+	if (clock > 31 || chipSelect > 31 || clock == chipSelect) return;
+	_CLKMask = 1u << clock;
+	_CSMask = 1u << chipSelect;
+	uint32_t used = _CLKMask | _CSMask;
+	for (uint8_t lane = 0; lane < laneCount; lane++)
+	{
+		if (dataPins[lane] > 31 || (used & (1u << dataPins[lane]))) return;
+		_DINMasks[lane] = 1u << dataPins[lane];
+		used |= _DINMasks[lane];
+		_Lanes[lane]._Owner = this;
+	}
+	_AllDINMask = used & ~(_CLKMask | _CSMask);
+	_LaneCount = laneCount;
+}
+
+/*!
+	@brief Set the GPIO to outputs, CS high, called by the first lane to begin
+	@return false if the pins are not valid or the GPIO port failed
+*/
+bool MAX7219_ParallelSWSPI::Begin(void)
+{
+	if (_Begun) return true;
+	if (_LaneCount == 0 || !_Port->Begin(_CLKMask | _CSMask | _AllDINMask)) return false;
+	_Port->Clear(_CLKMask | _AllDINMask);
+	_Port->Set(_CSMask);
+	_Begun = true;
+	return true;
+}
+
+/*!
+	@brief Send any queued transactions and set the GPIO low
+*/
+void MAX7219_ParallelSWSPI::End(void)
+{
+	if (!_Begun) return;
+	Flush();
+	_Port->Clear(_CLKMask | _CSMask | _AllDINMask);
+	_Begun = false;
+}
+
+/*!
+	@brief Get number of lanes
+	@return number of chains, 0 if the pins passed to the constructor are not valid
+*/
+uint8_t MAX7219_ParallelSWSPI::GetLaneCount(void) {return _LaneCount;}
+
+/*!
+	@brief Get the transport of one chain, pass it to the MAX7219_SS_RPI constructor
+	@param lane lane index, order of dataPins passed to the constructor
+	@return the lane transport, nullptr if lane is not valid
+*/
+MAX7219_Transport* MAX7219_ParallelSWSPI::GetLane(uint8_t lane)
+{
+	return (lane < _LaneCount) ? &_Lanes[lane] : nullptr;
+}
+
+/*!
+	@brief Send the queued transactions of all lanes at once and empty the queues
+	@note Call after writing every chain, e.g. after CommitFrame of each frame buffered display.
+		Not thread safe, use from the thread that writes the displays.
+*/
+void MAX7219_ParallelSWSPI::Flush(void)
+{
+	if (!_Begun) return;
+	size_t transactionCount = 0;
+	for (uint8_t lane = 0; lane < _LaneCount; lane++)
+	{
+		if (_Lanes[lane]._Lengths.size() > transactionCount) transactionCount = _Lanes[lane]._Lengths.size();
+	}
+
+	size_t cursors[MAX7219_MAX_LANES] = {};
+	for (size_t transaction = 0; transaction < transactionCount; transaction++)
+	{
+		uint16_t laneLengths[MAX7219_MAX_LANES] = {};
+		uint16_t length = 0;
+		for (uint8_t lane = 0; lane < _LaneCount; lane++)
+		{
+			if (transaction < _Lanes[lane]._Lengths.size()) laneLengths[lane] = _Lanes[lane]._Lengths[transaction];
+			if (laneLengths[lane] > length) length = laneLengths[lane];
+		}
+
+		_Port->Clear(_CSMask);
+		_Port->Hold(); // CS setup
+		for (uint16_t position = 0; position < length; position++)
+		{
+			uint32_t bitMasks[8] = {}; // DIN GPIO high for each bit, MSB first
+			for (uint8_t lane = 0; lane < _LaneCount; lane++)
+			{
+				const uint16_t padding = length - laneLengths[lane]; // leading NOP bytes
+				if (position < padding) continue;
+				const uint8_t value = _Lanes[lane]._Bytes[cursors[lane] + position - padding];
+				if (value == 0) continue;
+				for (uint8_t bit = 0; bit < 8; bit++)
+				{
+					if (value & (0x80 >> bit)) bitMasks[bit] |= _DINMasks[lane];
+				}
+			}
+			SendByteColumn(bitMasks);
+		}
+		_Port->Set(_CSMask);
+
+		for (uint8_t lane = 0; lane < _LaneCount; lane++) cursors[lane] += laneLengths[lane];
+	}
+
+	for (uint8_t lane = 0; lane < _LaneCount; lane++)
+	{
+		_Lanes[lane]._Bytes.clear();
+		_Lanes[lane]._Lengths.clear();
+	}
+}
+
+/*!
+	@brief Clock out one byte on every lane
+	@param bitMasks DIN GPIO to set high for each of the 8 bits, MSB first, the other DIN GPIO are set low
+	@note Same edge timing as MAX7219_TransportSWSPI FastTransfer and FastTransferDelay, which cannot be
+		called here as they shift one DIN pin of one chain: DIN is held before the CLK rise, and the
+		CLK levels are held by the port at CommDelay 0 or by the delays otherwise.
+*/
+void MAX7219_ParallelSWSPI::SendByteColumn(const uint32_t (&bitMasks)[8])
+{
+	for (uint8_t bit = 0; bit < 8; bit++)
+	{
+		const uint32_t setMask = bitMasks[bit];
+		const uint32_t clrMask = _AllDINMask & ~setMask;
+		if (setMask) _Port->Set(setMask);
+		if (clrMask) _Port->Clear(clrMask);
+		_Port->Hold(); // data setup
+		_Port->Set(_CLKMask);
+		_CommDelay ? MAX7219_MicroSecondDelay(_CommDelay) : _Port->Hold(); // clock high time
+		_Port->Clear(_CLKMask);
+		_CommDelay ? MAX7219_MicroSecondDelay(_CommDelay) : _Port->Hold(); // clock low time
+	}
+}
+
+/*!
+	@brief Set the communication delay value
+	@param commDelay Set the communication delay value uS
+*/
+void MAX7219_ParallelSWSPI::SetCommDelay(uint16_t commDelay) {_CommDelay = commDelay;}
+
+/*!
+	@brief Get the communication delay value
+	@return Get the communication delay value uS
+*/
+uint16_t MAX7219_ParallelSWSPI::GetCommDelay(void) {return _CommDelay;}
+
+// == EOF ==
@@ -0,0 +1,310 @@
+/*!
+	@file MAX7219_7SEG_RPI_Scheduler.cpp
+	@author Gavin Lyons
+	@brief library source file, timerfd based scheduler for display effects
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#include "MAX7219_7SEG_RPI_Scheduler.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+
+/*!
+	@brief Destructor, closes the timerfd
+*/
+MAX7219_Scheduler::~MAX7219_Scheduler()
+{
+	End();
+}
+
+/*!
+	@brief Create the timerfd
+	@return true if successful
+*/
+bool MAX7219_Scheduler::Begin(void)
+{
+	if (_TimerFd >= 0) return true;
+	_TimerFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+	if (_TimerFd < 0) return false;
+	Arm();
+	return true;
+}
+
+/*!
+	@brief Close the timerfd, tasks are kept
+*/
+void MAX7219_Scheduler::End(void)
+{
+	if (_TimerFd < 0) return;
+	close(_TimerFd);
+	_TimerFd = -1;
+}
+
+/*!
+	@brief Get the timerfd to add to a poll/epoll loop, readable (POLLIN) when a task is due
+	@return file descriptor, -1 if not begun
+*/
+int MAX7219_Scheduler::GetFd(void) {return _TimerFd;}
+
+/*!
+	@brief Add a periodic task, first run is within one period from now
+	@param periodMs period in milliseconds, minimum 1
+	@param task callback, return false to remove the task
+	@return task id for RemoveTask, -1 if every id is taken by a task
+	@note Ids wrap around after INT16_MAX, ids of tasks still in the list are skipped
+*/
+int16_t MAX7219_Scheduler::AddTask(uint32_t periodMs, Task_t task)
+{
+	const int64_t periodNs = (int64_t)std::max<uint32_t>(periodMs, 1) * 1000000;
+	if (_Tasks.size() > INT16_MAX) return -1;
+	int16_t id = _NextId;
+	while (std::any_of(_Tasks.begin(), _Tasks.end(), [id](const Entry_t &e){ return e.Id == id; }))
+	{
+		id = (id == INT16_MAX) ? 0 : id + 1;
+	}
+	_NextId = (id == INT16_MAX) ? 0 : id + 1;
+	const int64_t nowNs = NowNs();
+	if (_EpochNs == 0) _EpochNs = nowNs;
+	const int64_t deadlineNs = _EpochNs + ((nowNs - _EpochNs) / periodNs + 1) * periodNs;
+	_Tasks.push_back(Entry_t{id, periodNs, deadlineNs, std::move(task), false});
+	if (!_Dispatching) Arm();
+	return id;
+}
+
+/*!
+	@brief Remove a task, can be called from a task
+	@param id task id returned by AddTask
+	@return false if no task has that id
+*/
+bool MAX7219_Scheduler::RemoveTask(int16_t id)
+{
+	for (Entry_t &entry : _Tasks)
+	{
+		if (entry.Id == id && !entry.Removed)
+		{
+			entry.Removed = true;
+			if (!_Dispatching)
+			{
+				_Tasks.erase(std::remove_if(_Tasks.begin(), _Tasks.end(),
+					[](const Entry_t &e){ return e.Removed; }), _Tasks.end());
+				Arm();
+			}
+			return true;
+		}
+	}
+	return false;
+}
+
+/*!
+	@brief Get number of tasks scheduled
+	@return task count
+*/
+uint16_t MAX7219_Scheduler::GetTaskCount(void)
+{
+	return (uint16_t)std::count_if(_Tasks.begin(), _Tasks.end(),
+		[](const Entry_t &e){ return !e.Removed; });
+}
+
+/*!
+	@brief Run every task whose deadline has passed and re-arm the timerfd
+	@return number of tasks run
+	@note Call when GetFd is readable. A task that missed several deadlines runs once
+		and its next deadline is the first one still in the future.
+*/
+uint16_t MAX7219_Scheduler::Dispatch(void)
+{
+	if (_TimerFd >= 0)
+	{
+		uint64_t expirations;
+		while (read(_TimerFd, &expirations, sizeof(expirations)) > 0) {} // drain
+	}
+	const int64_t nowNs = NowNs();
+	uint16_t runCount = 0;
+	_Dispatching = true;
+	for (size_t index = 0; index < _Tasks.size(); index++)
+	{
+		if (_Tasks[index].Removed || _Tasks[index].DeadlineNs > nowNs) continue;
+		Entry_t &entry = _Tasks[index];
+		entry.DeadlineNs += entry.PeriodNs;
+		if (entry.DeadlineNs <= nowNs) // fell behind, skip missed ticks keeping the phase
+			entry.DeadlineNs += ((nowNs - entry.DeadlineNs) / entry.PeriodNs + 1) * entry.PeriodNs;
+		Task_t task = entry.Task; // task may add tasks and move _Tasks
+		runCount++;
+		if (!task()) _Tasks[index].Removed = true;
+	}
+	_Dispatching = false;
+	_Tasks.erase(std::remove_if(_Tasks.begin(), _Tasks.end(),
+		[](const Entry_t &e){ return e.Removed; }), _Tasks.end());
+	Arm();
+	return runCount;
+}
+
+/*!
+	@brief Wait on the timerfd and dispatch tasks
+	@param durationMs time to run for, 0 = until Stop is called or no tasks are left
+*/
+void MAX7219_Scheduler::Run(uint32_t durationMs)
+{
+	if (!Begin()) return;
+	_Stop = false;
+	const int64_t endNs = NowNs() + (int64_t)durationMs * 1000000;
+	while (!_Stop && !_Tasks.empty())
+	{
+		int timeoutMs = -1;
+		if (durationMs > 0)
+		{
+			const int64_t leftNs = endNs - NowNs();
+			if (leftNs <= 0) break;
+			timeoutMs = (int)((leftNs + 999999) / 1000000);
+		}
+		struct pollfd pfd = {_TimerFd, POLLIN, 0};
+		const int result = poll(&pfd, 1, timeoutMs);
+		if (result < 0 && errno != EINTR) break;
+		if (result > 0) Dispatch();
+	}
+}
+
+/*!
+	@brief Make Run return, can be called from a task or another thread
+*/
+void MAX7219_Scheduler::Stop(void) {_Stop = true;}
+
+/*!
+	@brief Arm the timerfd for the earliest deadline, disarm if no tasks
+*/
+void MAX7219_Scheduler::Arm(void)
+{
+	if (_TimerFd < 0) return;
+	struct itimerspec spec = {};
+	bool any = false;
+	int64_t earliest = 0;
+	for (const Entry_t &entry : _Tasks)
+	{
+		if (entry.Removed) continue;
+		if (!any || entry.DeadlineNs < earliest) earliest = entry.DeadlineNs;
+		any = true;
+	}
+	if (any)
+	{
+		spec.it_value.tv_sec = earliest / 1000000000;
+		spec.it_value.tv_nsec = earliest % 1000000000;
+		if (spec.it_value.tv_sec == 0 && spec.it_value.tv_nsec == 0) spec.it_value.tv_nsec = 1;
+	}
+	timerfd_settime(_TimerFd, TFD_TIMER_ABSTIME, &spec, nullptr);
+}
+
+/*!
+	@brief Blink a display by toggling its shutdown mode
+	@param display display object of the chain
+	@param displayNumber display in the chain, 1 to MAX7219_MAX_DISPLAYS
+	@param periodMs time between toggles
+	@return task id
+*/
+int16_t MAX7219_Scheduler::AddBlink(MAX7219_SS_RPI *display, uint8_t displayNumber, uint32_t periodMs)
+{
+	bool off = false;
+	return AddTask(periodMs, [display, displayNumber, off]() mutable
+	{
+		const uint8_t current = display->GetCurrentDisplayNumber();
+		off = !off;
+		display->SetCurrentDisplayNumber(displayNumber);
+		display->ShutdownMode(off);
+		display->SetCurrentDisplayNumber(current);
+		return true;
+	});
+}
+
+/*!
+	@brief Fade a display brightness up and down, one intensity step per period
+	@param display display object of the chain
+	@param displayNumber display in the chain, 1 to MAX7219_MAX_DISPLAYS
+	@param periodMs time between intensity steps
+	@return task id
+*/
+int16_t MAX7219_Scheduler::AddFade(MAX7219_SS_RPI *display, uint8_t displayNumber, uint32_t periodMs)
+{
+	uint8_t step = 0;
+	return AddTask(periodMs, [display, displayNumber, step]() mutable
+	{
+		const uint8_t current = display->GetCurrentDisplayNumber();
+		const uint8_t brightness = (step < 16) ? step : 30 - step; // 0..15..1
+		step = (step + 1) % 30;
+		display->SetCurrentDisplayNumber(displayNumber);
+		display->SetBrightness(brightness);
+		display->SetCurrentDisplayNumber(current);
+		return true;
+	});
+}
+
+/*!
+	@brief Step a marquee at its step interval
+	@param marquee the marquee, its message and displays must be set
+	@return task id
+	@note The interval is read when the task is added
+*/
+int16_t MAX7219_Scheduler::AddMarquee(MAX7219_Marquee *marquee)
+{
+	marquee->Draw();
+	return AddTask(marquee->GetStepInterval(), [marquee]()
+	{
+		marquee->Step();
+		return true;
+	});
+}
+
+/*!
+	@brief Show a counter on a display, right aligned
+	@param display display object of the chain
+	@param displayNumber display in the chain, 1 to MAX7219_MAX_DISPLAYS
+	@param periodMs time between counts
+	@param start first value shown
+	@param step added to the value each period, may be negative
+	@return task id
+	@note In frame buffered mode each count is sent with CommitFrame
+*/
+int16_t MAX7219_Scheduler::AddCounter(MAX7219_SS_RPI *display, uint8_t displayNumber, uint32_t periodMs,
+	long start, long step)
+{
+	long value = start;
+	return AddTask(periodMs, [display, displayNumber, value, step]() mutable
+	{
+		const uint8_t current = display->GetCurrentDisplayNumber();
+		display->SetCurrentDisplayNumber(displayNumber);
+		display->DisplayFixedNum(value, 0, display->AlignRight);
+		display->SetCurrentDisplayNumber(current);
+		if (display->GetFrameBuffered()) display->CommitFrame();
+		value += step;
+		return true;
+	});
+}
+
+/*!
+	@brief Get the monotonic clock used for deadlines
+	@return CLOCK_MONOTONIC in nanoseconds
+*/
+int64_t MAX7219_Scheduler::NowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+/*!
+	@brief Sleep until an absolute deadline, for loops that must not drift
+	@param deadlineNs CLOCK_MONOTONIC time in nanoseconds, see NowNs
+	@note e.g. deadline += period; SleepUntilNs(deadline); instead of a relative delay
+*/
+void MAX7219_Scheduler::SleepUntilNs(int64_t deadlineNs)
+{
+	struct timespec ts;
+	ts.tv_sec = deadlineNs / 1000000000;
+	ts.tv_nsec = deadlineNs % 1000000000;
+	while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+}
+
+// == EOF ==
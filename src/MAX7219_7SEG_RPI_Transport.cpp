@@ -0,0 +1,607 @@
+/*!
+	@file MAX7219_7SEG_RPI_Transport.cpp
+	@author Gavin Lyons
+	@brief library source file, bus transports used to send data to MAX7219 displays
+	Project Name: MAX7219_7SEG_RPI
+	@note  See URL for full details. https://github.com/gavinlyonsrepo/MAX7219_7SEG_RPI
+*/
+
+#include "MAX7219_7SEG_RPI_Transport.hpp"
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+
+#ifdef MAX7219_NO_BCM2835
+#include <time.h>
+
+/*!
+	@brief Microsecond delay for off device builds
+	@param micros delay in microseconds
+*/
+void MAX7219_DelayMicroseconds(uint64_t micros)
+{
+	struct timespec ts;
+	ts.tv_sec = micros / 1000000;
+	ts.tv_nsec = (micros % 1000000) * 1000;
+	nanosleep(&ts, nullptr);
+}
+
+/*!
+	@brief Millisecond delay for off device builds
+	@param millis delay in milliseconds
+*/
+void MAX7219_DelayMilliseconds(unsigned int millis)
+{
+	MAX7219_DelayMicroseconds((uint64_t)millis * 1000);
+}
+#endif
+
+// MAX7219_Transport
+
+/*!
+	@brief Send several transactions of the same length
+	@param buffer the transactions back to back, count*length bytes
+	@param length number of bytes in each transaction
+	@param count number of transactions
+	@note Default sends each one with Transfer, transports that can queue transactions override it.
+*/
+void MAX7219_Transport::TransferBatch(const uint8_t *buffer, uint16_t length, uint16_t count)
+{
+	for (uint16_t i = 0; i < count; i++)
+	{
+		Transfer(buffer + (i * length), length);
+	}
+}
+
+#ifndef MAX7219_NO_BCM2835
+
+// MAX7219_TransportSWSPI
+
+/*!
+	@brief Constructor for software SPI transport
+	@param clock CLk pin
+	@param chipSelect CS pin
+	@param data DIO pin
+*/
+MAX7219_TransportSWSPI::MAX7219_TransportSWSPI(uint8_t clock, uint8_t chipSelect, uint8_t data)
+{
+	_MAX7219_CLK_IO = clock;
+	_MAX7219_CS_IO  = chipSelect;
+	_MAX7219_DIN_IO = data;
+}
+
+/*!
+	@brief Set the GPIO to outputs
+	@return always true
+*/
+bool MAX7219_TransportSWSPI::Begin(void)
+{
+	MAX7219_CS_SetDigitalOutput;
+	MAX7219_CLK_SetDigitalOutput;
+	MAX7219_DIN_SetDigitalOutput;
+	MAX7219_CS_SetHigh;
+
+	// fast path, all GPIO in bank 0 so one GPSET0/GPCLR0 write per edge
+	if (_MAX7219_CS_IO < 32 && _MAX7219_CLK_IO < 32 && _MAX7219_DIN_IO < 32)
+	{
+		volatile uint32_t *gpio = bcm2835_regbase(BCM2835_REGBASE_GPIO);
+		if (gpio != nullptr && gpio != (uint32_t*)MAP_FAILED)
+		{
+			_GpioSet = gpio + BCM2835_GPSET0/4;
+			_GpioClr = gpio + BCM2835_GPCLR0/4;
+			_GpioLev = gpio + BCM2835_GPLEV0/4;
+			_CSMask  = (1u << _MAX7219_CS_IO);
+			_CLKMask = (1u << _MAX7219_CLK_IO);
+			_DINMask = (1u << _MAX7219_DIN_IO);
+		}
+	}
+	return true;
+}
+
+/*!
+	@brief Set the GPIO low
+*/
+void MAX7219_TransportSWSPI::End(void)
+{
+	MAX7219_CS_SetLow;
+	MAX7219_CLK_SetLow;
+	MAX7219_DIN_SetLow;
+}
+
+/*!
+	@brief Send one transaction by bit banging
+	@param buffer the bytes to send
+	@param length number of bytes in buffer
+*/
+void MAX7219_TransportSWSPI::Transfer(const uint8_t *buffer, uint16_t length)
+{
+	if (_GpioSet != nullptr)
+	{
+		_CommDelay == 0 ? FastTransfer(buffer, length) : FastTransferDelay(buffer, length);
+		return;
+	}
+	MAX7219_CS_SetLow;
+	for (uint16_t i = 0; i < length; i++)
+	{
+		HighFreqshiftOut(buffer[i]);
+	}
+	MAX7219_CS_SetHigh;
+}
+
+/*!
+	@brief Set the communication delay value
+	@param commDelay Set the communication delay value uS
+*/
+void MAX7219_TransportSWSPI::SetCommDelay(uint16_t commDelay) {_CommDelay = commDelay;}
+
+/*!
+	@brief Get the communication delay value
+	@return Get the communication delay value uS
+*/
+uint16_t MAX7219_TransportSWSPI::GetCommDelay(void) {return _CommDelay;}
+
+ /*!
+	@brief Shifts out a uint8_t of data on to the MAX7219 SPI-like bus
+	@param value The uint8_t of data to shift out
+	@note _CommDelay microsecond delay may have to be adjusted depending on processor.
+		Slow path for GPIO above 31, bcm2835_gpio_write has a memory barrier around each write and
+		the delay call reads the system timer, also at CommDelay 0.
+*/
+void MAX7219_TransportSWSPI::HighFreqshiftOut(uint8_t value)
+{
+
+	for (uint8_t bit = 0; bit < 8; bit++)
+	{
+		!!(value & (1 << (7 - bit))) ? MAX7219_DIN_SetHigh: MAX7219_DIN_SetLow; // MSBFIRST
+		MAX7219_CLK_SetHigh;
+		MAX7219_MicroSecondDelay(_CommDelay);
+		MAX7219_CLK_SetLow;
+		MAX7219_MicroSecondDelay(_CommDelay);
+	}
+}
+
+/*!
+	@brief Send one transaction by writing GPSET0/GPCLR0 directly, no delays
+	@param buffer the bytes to send
+	@param length number of bytes in buffer
+	@note Every edge is held with MAX7219_GpioEdgeHold: DIN before the CLK rise (data setup),
+		CLK high (clock high time) and CLK low before the next DIN write (clock low time).
+*/
+void MAX7219_TransportSWSPI::FastTransfer(const uint8_t *buffer, uint16_t length)
+{
+	volatile uint32_t *gpioSet = _GpioSet;
+	volatile uint32_t *gpioClr = _GpioClr;
+	volatile uint32_t *gpioLev = _GpioLev;
+	const uint32_t clkMask = _CLKMask;
+	const uint32_t dinMask = _DINMask;
+
+	bcm2835_peri_write(gpioClr, _CSMask); // barrier before first access
+	MAX7219_GpioEdgeHold(gpioLev); // CS setup
+	for (uint16_t i = 0; i < length; i++)
+	{
+		const uint8_t value = buffer[i];
+		for (uint8_t bitMask = 0x80; bitMask; bitMask >>= 1) // MSBFIRST
+		{
+			bcm2835_peri_write_nb((value & bitMask) ? gpioSet : gpioClr, dinMask);
+			MAX7219_GpioEdgeHold(gpioLev);
+			bcm2835_peri_write_nb(gpioSet, clkMask);
+			MAX7219_GpioEdgeHold(gpioLev);
+			bcm2835_peri_write_nb(gpioClr, clkMask);
+			MAX7219_GpioEdgeHold(gpioLev);
+		}
+	}
+	bcm2835_peri_write(gpioSet, _CSMask);
+}
+
+/*!
+	@brief Send one transaction by writing GPSET0/GPCLR0 directly, with CommDelay after each clock edge
+	@param buffer the bytes to send
+	@param length number of bytes in buffer
+	@note DIN is held with MAX7219_GpioEdgeHold before the CLK rise, the delays hold the CLK levels.
+*/
+void MAX7219_TransportSWSPI::FastTransferDelay(const uint8_t *buffer, uint16_t length)
+{
+	bcm2835_peri_write(_GpioClr, _CSMask);
+	MAX7219_GpioEdgeHold(_GpioLev); // CS setup
+	for (uint16_t i = 0; i < length; i++)
+	{
+		const uint8_t value = buffer[i];
+		for (uint8_t bitMask = 0x80; bitMask; bitMask >>= 1) // MSBFIRST
+		{
+			bcm2835_peri_write_nb((value & bitMask) ? _GpioSet : _GpioClr, _DINMask);
+			MAX7219_GpioEdgeHold(_GpioLev);
+			bcm2835_peri_write_nb(_GpioSet, _CLKMask);
+			MAX7219_MicroSecondDelay(_CommDelay);
+			bcm2835_peri_write_nb(_GpioClr, _CLKMask);
+			MAX7219_MicroSecondDelay(_CommDelay);
+		}
+	}
+	bcm2835_peri_write(_GpioSet, _CSMask);
+}
+
+// MAX7219_TransportHWSPI
+
+std::mutex MAX7219_TransportHWSPI::_SPI0Mutex;
+const MAX7219_TransportHWSPI *MAX7219_TransportHWSPI::_SPI0Owner = nullptr;
+uint8_t MAX7219_TransportHWSPI::_SPI0Users = 0;
+
+/*!
+	@brief Constructor for hardware SPI transport
+	@param kiloHertz SPI bus speed in kilohetrz
+	@param SPICEX_PIN Which SPICX pin to use 1 or 0
+*/
+MAX7219_TransportHWSPI::MAX7219_TransportHWSPI(uint32_t kiloHertz, uint8_t SPICEX_PIN)
+{
+	_KiloHertz = kiloHertz;
+	_SPICEX_CS_IO = SPICEX_PIN;
+}
+
+/*!
+	@brief Start SPI0 and apply settings
+	@details SPI0 is only started by the first transport to begin, later ones
+		(e.g. the CE1 chain while the CE0 chain runs) just register as users.
+	@return true if successful, false otherwise (perhaps because you are not running as root)
+*/
+bool MAX7219_TransportHWSPI::Begin(void)
+{
+	std::lock_guard<std::mutex> spiLock(_SPI0Mutex);
+	if (!_SPI0Begun)
+	{
+		if (_SPI0Users == 0 && !bcm2835_spi_begin())
+		{
+			return false;
+		}
+		_SPI0Users++;
+		_SPI0Begun = true;
+	}
+	ApplySettings();
+	_SPI0Owner = this;
+	return true;
+}
+
+/*!
+	@brief End SPI operations. SPI0 pins P1-19 (MOSI), P1-21 (MISO), P1-23 (CLK), P1-24 (CE0) and P1-26 (CE1)
+		are returned to their default INPUT behaviour.
+	@note SPI0 is only ended when the last transport that began it ends,
+		so ending the CE0 chain does not cut off a CE1 chain still in use.
+*/
+void MAX7219_TransportHWSPI::End(void)
+{
+	std::lock_guard<std::mutex> spiLock(_SPI0Mutex);
+	if (!_SPI0Begun) return;
+	_SPI0Begun = false;
+	if (_SPI0Owner == this) _SPI0Owner = nullptr;
+	if (--_SPI0Users == 0) bcm2835_spi_end();
+}
+
+/*!
+	@brief  Init Hardware SPI settings
+	@details MSBFIRST, mode 0 , SPI Speed , SPICEX pin
+	@note If multiple devices on SPI bus with different settings,
+	can be used to refresh MAX7219 settings
+*/
+void MAX7219_TransportHWSPI::RefreshSettings(void)
+{
+	std::lock_guard<std::mutex> spiLock(_SPI0Mutex);
+	ApplySettings();
+	_SPI0Owner = this;
+}
+
+/*!
+	@brief Program SPI0 with this transport's settings, caller holds _SPI0Mutex
+*/
+void MAX7219_TransportHWSPI::ApplySettings(void)
+{
+	bcm2835_spi_setBitOrder(BCM2835_SPI_BIT_ORDER_MSBFIRST);
+	bcm2835_spi_setDataMode(BCM2835_SPI_MODE0);
+
+	// SPI bus speed
+	if (_KiloHertz > 0)
+		bcm2835_spi_set_speed_hz(_KiloHertz * 1000);
+	else // default, BCM2835_SPI_CLOCK_DIVIDER_64 3.90MHz Rpi2, 6.250MHz RPI3
+		bcm2835_spi_setClockDivider(BCM2835_SPI_CLOCK_DIVIDER_64);
+
+	// Chip enable pin select
+	if (_SPICEX_CS_IO == 0)
+	{
+		bcm2835_spi_chipSelect(BCM2835_SPI_CS0);
+		bcm2835_spi_setChipSelectPolarity(BCM2835_SPI_CS0, LOW);
+	}else if (_SPICEX_CS_IO == 1)
+	{
+		bcm2835_spi_chipSelect(BCM2835_SPI_CS1);
+		bcm2835_spi_setChipSelectPolarity(BCM2835_SPI_CS1, LOW);
+	}
+}
+
+/*!
+	@brief Send one transaction on SPI0
+	@param buffer the bytes to send
+	@param length number of bytes in buffer
+*/
+void MAX7219_TransportHWSPI::Transfer(const uint8_t *buffer, uint16_t length)
+{
+	std::lock_guard<std::mutex> spiLock(_SPI0Mutex);
+	if (_SPI0Owner != this)
+	{
+		ApplySettings();
+		_SPI0Owner = this;
+	}
+	bcm2835_spi_writenb((const char*)buffer, length);
+}
+
+/*!
+	@brief Send several transactions on SPI0 holding the bus once
+	@param buffer the transactions back to back, count*length bytes
+	@param length number of bytes in each transaction
+	@param count number of transactions
+*/
+void MAX7219_TransportHWSPI::TransferBatch(const uint8_t *buffer, uint16_t length, uint16_t count)
+{
+	std::lock_guard<std::mutex> spiLock(_SPI0Mutex);
+	if (_SPI0Owner != this)
+	{
+		ApplySettings();
+		_SPI0Owner = this;
+	}
+	for (uint16_t i = 0; i < count; i++)
+	{
+		bcm2835_spi_writenb((const char*)(buffer + (i * length)), length);
+	}
+}
+
+// MAX7219_TransportAuxSPI
+
+/*!
+	@brief Constructor for auxiliary hardware SPI transport
+	@param kiloHertz SPI1 bus speed in kilohetrz
+*/
+MAX7219_TransportAuxSPI::MAX7219_TransportAuxSPI(uint32_t kiloHertz)
+{
+	_KiloHertz = kiloHertz;
+}
+
+/*!
+	@brief Start SPI1 and apply settings
+	@return true if successful, false otherwise (perhaps because you are not running as root)
+*/
+bool MAX7219_TransportAuxSPI::Begin(void)
+{
+	if(!bcm2835_aux_spi_begin())
+	{
+		return false;
+	}
+	RefreshSettings();
+	return true;
+}
+
+/*!
+	@brief End SPI1 operations, pins are returned to their default INPUT behaviour.
+*/
+void MAX7219_TransportAuxSPI::End(void)
+{
+	bcm2835_aux_spi_end();
+}
+
+/*!
+	@brief Set SPI1 bus speed, mode 0 MSB first is fixed by the peripheral
+*/
+void MAX7219_TransportAuxSPI::RefreshSettings(void)
+{
+	if (_KiloHertz > 0)
+		bcm2835_aux_spi_setClockDivider(bcm2835_aux_spi_CalcClockDivider(_KiloHertz * 1000));
+}
+
+/*!
+	@brief Send one transaction on SPI1
+	@param buffer the bytes to send
+	@param length number of bytes in buffer
+*/
+void MAX7219_TransportAuxSPI::Transfer(const uint8_t *buffer, uint16_t length)
+{
+	bcm2835_aux_spi_writenb((const char*)buffer, length);
+}
+
+/*!
+	@brief Send several transactions on SPI1
+	@param buffer the transactions back to back, count*length bytes
+	@param length number of bytes in each transaction
+	@param count number of transactions
+*/
+void MAX7219_TransportAuxSPI::TransferBatch(const uint8_t *buffer, uint16_t length, uint16_t count)
+{
+	for (uint16_t i = 0; i < count; i++)
+	{
+		bcm2835_aux_spi_writenb((const char*)(buffer + (i * length)), length);
+	}
+}
+
+#endif // MAX7219_NO_BCM2835
+
+// MAX7219_TransportSpidev
+
+/*!
+	@brief Constructor for Linux spidev transport
+	@param device path of spidev device node e.g. "/dev/spidev0.0"
+	@param kiloHertz SPI bus speed in kilohetrz
+*/
+MAX7219_TransportSpidev::MAX7219_TransportSpidev(const char *device, uint32_t kiloHertz)
+{
+	strncpy(_Device, device, sizeof(_Device) - 1);
+	_KiloHertz = kiloHertz;
+}
+
+/*!
+	@brief Destructor closes the device node if open
+*/
+MAX7219_TransportSpidev::~MAX7219_TransportSpidev()
+{
+	End();
+}
+
+/*!
+	@brief Open the spidev device node and apply settings, mode 0, 8 bits, MSB first
+	@return true if successful, false otherwise (device missing or no permission)
+*/
+bool MAX7219_TransportSpidev::Begin(void)
+{
+	if (_FileDescriptor >= 0) return true;
+	_FileDescriptor = open(_Device, O_RDWR);
+	if (_FileDescriptor < 0)
+	{
+		return false;
+	}
+	uint8_t mode = SPI_MODE_0;
+	uint8_t bits = 8;
+	uint32_t speedHz = _KiloHertz * 1000;
+	if (ioctl(_FileDescriptor, SPI_IOC_WR_MODE, &mode) < 0 ||
+		ioctl(_FileDescriptor, SPI_IOC_WR_BITS_PER_WORD, &bits) < 0 ||
+		ioctl(_FileDescriptor, SPI_IOC_WR_MAX_SPEED_HZ, &speedHz) < 0)
+	{
+		End();
+		return false;
+	}
+	return true;
+}
+
+/*!
+	@brief Close the spidev device node
+*/
+void MAX7219_TransportSpidev::End(void)
+{
+	if (_FileDescriptor >= 0)
+	{
+		close(_FileDescriptor);
+		_FileDescriptor = -1;
+	}
+}
+
+/*!
+	@brief Send one transaction
+	@param buffer the bytes to send
+	@param length number of bytes in buffer
+*/
+void MAX7219_TransportSpidev::Transfer(const uint8_t *buffer, uint16_t length)
+{
+	TransferBatch(buffer, length, 1);
+}
+
+/*!
+	@brief Send several transactions of the same length with as few ioctl calls as possible
+	@param buffer the transactions back to back, count*length bytes
+	@param length number of bytes in each transaction
+	@param count number of transactions
+	@details Each transaction is a spi_ioc_transfer with cs_change set so chip select
+		is released between them, latching the data in the displays.
+*/
+void MAX7219_TransportSpidev::TransferBatch(const uint8_t *buffer, uint16_t length, uint16_t count)
+{
+	struct spi_ioc_transfer transfers[MaxTransfersPerMessage];
+	uint16_t perMessage = MaxTransfersPerMessage;
+	if (length > 0 && (MaxBytesPerMessage / length) < perMessage)
+		perMessage = MaxBytesPerMessage / length;
+	if (perMessage == 0) perMessage = 1;
+
+	while (count > 0)
+	{
+		const uint16_t batch = (count < perMessage) ? count : perMessage;
+		memset(transfers, 0, sizeof(transfers[0]) * batch);
+		for (uint16_t i = 0; i < batch; i++)
+		{
+			transfers[i].tx_buf = (unsigned long)(buffer + (i * length));
+			transfers[i].len = length;
+			transfers[i].speed_hz = _KiloHertz * 1000;
+			transfers[i].bits_per_word = 8;
+			transfers[i].cs_change = (i < batch - 1) ? 1 : 0; // last one releases CS at end of message
+		}
+		if (ioctl(_FileDescriptor, SPI_IOC_MESSAGE(batch), transfers) < 0)
+		{
+			_ErrorCount++;
+		}
+		buffer += batch * length;
+		count -= batch;
+	}
+}
+
+/*!
+	@brief Get number of failed transfers
+	@return number of ioctl calls that returned an error
+*/
+uint32_t MAX7219_TransportSpidev::GetErrorCount(void) {return _ErrorCount;}
+
+// MAX7219_TransportRecorder
+
+/*!
+	@brief Constructor for in memory recording transport
+	@param keepData true store the bytes of each transaction, false only count them
+*/
+MAX7219_TransportRecorder::MAX7219_TransportRecorder(bool keepData)
+{
+	_KeepData = keepData;
+}
+
+/*!
+	@brief Start the recorder, nothing to do
+	@return always true
+*/
+bool MAX7219_TransportRecorder::Begin(void) {return true;}
+
+/*!
+	@brief End the recorder, nothing to do
+*/
+void MAX7219_TransportRecorder::End(void) {}
+
+/*!
+	@brief Record one transaction
+	@param buffer the bytes to send
+	@param length number of bytes in buffer
+*/
+void MAX7219_TransportRecorder::Transfer(const uint8_t *buffer, uint16_t length)
+{
+	_TransactionCount++;
+	_ByteCount += length;
+	if (_KeepData)
+	{
+		_Bytes.insert(_Bytes.end(), buffer, buffer + length);
+		_TransactionLengths.push_back(length);
+	}
+}
+
+/*!
+	@brief Forget all recorded transactions and reset counts
+*/
+void MAX7219_TransportRecorder::Clear(void)
+{
+	_TransactionCount = 0;
+	_ByteCount = 0;
+	_Bytes.clear();
+	_TransactionLengths.clear();
+}
+
+/*!
+	@brief Get number of transactions since last Clear
+	@return number of transactions
+*/
+uint32_t MAX7219_TransportRecorder::GetTransactionCount(void) {return _TransactionCount;}
+
+/*!
+	@brief Get number of bytes since last Clear
+	@return number of bytes
+*/
+uint32_t MAX7219_TransportRecorder::GetByteCount(void) {return _ByteCount;}
+
+/*!
+	@brief Get the recorded bytes of every transaction back to back
+	@return reference to the recorded bytes
+*/
+const std::vector<uint8_t>& MAX7219_TransportRecorder::GetBytes(void) {return _Bytes;}
+
+/*!
+	@brief Get the length of each recorded transaction
+	@return reference to the transaction lengths
+*/
+const std::vector<uint16_t>& MAX7219_TransportRecorder::GetTransactionLengths(void) {return _TransactionLengths;}
+
+// == EOF ==
@@ -0,0 +1,825 @@
+/*!
+	@file MAX7219_7SEG_RPI/test/src/main.cpp
+	@author Gavin Lyons
+	@brief Off device checks for Max7219 seven segment displays library
+	Runs against MAX7219_TransportRecorder and MAX7219_Emulator, no hardware or bcm2835 library needed.
+
+	Project Name: MAX7219_7SEG_RPI
+
+	@details
+		Each check prints PASS or FAIL with the failed conditions. The exit status is the number
+		of failed checks, so "make run" fails if any check fails.
+		- spidev batch: a frame is sent as one SPI_IOC_MESSAGE ioctl with one transfer per
+		  chip select window, ioctl is interposed and the transfers decoded by the emulator.
+		- parallel lanes: chains of different lengths clocked together by MAX7219_ParallelSWSPI
+		  end up in the same state as the same writes sent to each chain on its own, and every
+		  CLK edge is held by the GPIO port at CommDelay 0.
+		- capture replay: a capture file read back gives the exact transactions sent, and replayed
+		  into the emulator gives the same displays.
+		- scheduler ids: after the task id counter wraps, ids of live tasks are not given out again.
+		- init chain: mixed scan limits are rejected without bus traffic, one scan limit with mixed
+		  decode modes and brightness inits and blanks every display.
+		- frame cache async: cached wide frames drawn while the render thread runs, queue and
+		  latest wins mode, end on the last frame drawn. Run with make tsan to check for races.
+		- async shadow: RefreshDisplay, InvalidateShadow and control writes while the render thread
+		  sends frames, InitDisplay and InitChain refused until StopAsync. Run with make tsan.
+		- latest wins: StartAsyncLatest keeps only the newest frame, drops repeats of the last
+		  commit, sends no faster than maxRefreshHz and ends on the last frame committed.
+		- frame cache collisions: keys with the same hash keep their own frames.
+		- cascade padding: a write to one display of a chain spans the whole chain with NOPs for
+		  the other displays, which keep their contents.
+		- number format: DisplayIntNum and DisplayDecNumNibble give the same digits as the snprintf
+		  formats they replaced on 8 digits, numbers fit fewer scanned digits and a decimal point
+		  far past the last digit is kept.
+		- chip stats: every display of a chain counts the pair it latched from each transaction,
+		  and its share of the transport time.
+		- frame scan limit: a frame to displays scanning 4 digits sends digits 1-4 only, also after
+		  InvalidateShadow.
+		- frame cache lookups: the hash index finds every entry through evictions and Clear, and
+		  wide writes that can never be cached (short text or AlignLeft numbers) are not looked up.
+	@note Usage: ./bin/check
+*/
+
+// Libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <linux/spi/spidev.h>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <MAX7219_7SEG_RPI.hpp>
+#include <MAX7219_7SEG_RPI_Emulator.hpp>
+#include <MAX7219_7SEG_RPI_Parallel.hpp>
+#include <MAX7219_7SEG_RPI_Scheduler.hpp>
+
+// A check, returns number of failed conditions
+typedef uint32_t (*CheckFunc_t)(void);
+
+// One check
+struct Check_t
+{
+	const char *Name;
+	CheckFunc_t Func;
+};
+
+// Report a failed condition and count it
+#define CHECK(condition) \
+	do { if (!(condition)) { printf("  failed: %s (line %d)\n", #condition, __LINE__); failures++; } } while (0)
+
+// Function Prototypes
+uint32_t CheckSpidevBatch(void);
+uint32_t CheckParallelLanes(void);
+void DrawLaneTest(MAX7219_SS_RPI &display, uint8_t lane, uint8_t round);
+uint32_t CheckCaptureReplay(void);
+uint32_t CheckSchedulerIds(void);
+uint32_t CheckInitChain(void);
+uint32_t CheckFrameCacheAsync(void);
+uint32_t CheckFrameCacheCollisions(void);
+uint32_t CheckAsyncShadow(void);
+uint32_t CheckLatestWins(void);
+uint32_t CheckNumberFormat(void);
+uint32_t CheckCascadePadding(void);
+uint32_t CheckChipStats(void);
+uint32_t CheckFrameScanLimit(void);
+uint32_t CheckFrameCacheLookups(void);
+void SnprintfIntNum(MAX7219_SS_RPI &display, unsigned long number, MAX7219_SS_RPI::TextAlignment_e alignment);
+void SnprintfDecNumNibble(MAX7219_SS_RPI &display, uint16_t numberUpper, uint16_t numberLower,
+	MAX7219_SS_RPI::TextAlignment_e alignment);
+bool InitEmulatedChain(MAX7219_SS_RPI &display, uint8_t chainLength);
+
+const Check_t Checks[] =
+{
+	{"spidev batch", CheckSpidevBatch},
+	{"parallel lanes", CheckParallelLanes},
+	{"capture replay", CheckCaptureReplay},
+	{"scheduler ids", CheckSchedulerIds},
+	{"init chain", CheckInitChain},
+	{"frame cache async", CheckFrameCacheAsync},
+	{"frame cache collisions", CheckFrameCacheCollisions},
+	{"async shadow", CheckAsyncShadow},
+	{"latest wins", CheckLatestWins},
+	{"number format", CheckNumberFormat},
+	{"cascade padding", CheckCascadePadding},
+	{"chip stats", CheckChipStats},
+	{"frame scan limit", CheckFrameScanLimit},
+	{"frame cache lookups", CheckFrameCacheLookups},
+};
+
+// Main loop
+int main(void)
+{
+	int failed = 0;
+	for (const Check_t &check : Checks)
+	{
+		const uint32_t failures = check.Func();
+		printf("%s :: %s\n", failures == 0 ? "PASS" : "FAIL", check.Name);
+		if (failures > 0) failed++;
+	}
+	printf("%d of %zu checks failed\n", failed, sizeof(Checks) / sizeof(Checks[0]));
+	return failed;
+}
+// End of main
+
+// Function Space
+
+// Init every display of a chain with InitDisplay, display one last
+bool InitEmulatedChain(MAX7219_SS_RPI &display, uint8_t chainLength)
+{
+	for (uint8_t number = chainLength; number >= 1; number--)
+	{
+		display.SetCurrentDisplayNumber(number);
+		if (!display.InitDisplay(display.ScanEightDigit, display.DecodeModeNone)) return false;
+	}
+	return true;
+}
+
+// spidev ioctl calls seen by the interposed ioctl below
+struct SpidevMessage_t
+{
+	std::vector<std::vector<uint8_t>> Transfers; // bytes of each spi_ioc_transfer
+	std::vector<bool> CsChange; // cs_change of each spi_ioc_transfer
+};
+static std::vector<SpidevMessage_t> SpidevMessages;
+
+// Interposes the C library ioctl: spidev requests are recorded and succeed, others go to the kernel
+extern "C" int ioctl(int fd, unsigned long request, ...)
+{
+	va_list args;
+	va_start(args, request);
+	void *argument = va_arg(args, void *);
+	va_end(args);
+	if (_IOC_TYPE(request) != SPI_IOC_MAGIC)
+		return (int)syscall(SYS_ioctl, fd, request, argument);
+	if (_IOC_NR(request) == 0 && _IOC_DIR(request) == _IOC_WRITE) // SPI_IOC_MESSAGE(n)
+	{
+		const spi_ioc_transfer *transfers = static_cast<const spi_ioc_transfer *>(argument);
+		SpidevMessage_t message;
+		for (size_t i = 0; i < _IOC_SIZE(request) / sizeof(spi_ioc_transfer); i++)
+		{
+			const uint8_t *tx = reinterpret_cast<const uint8_t *>(transfers[i].tx_buf);
+			message.Transfers.emplace_back(tx, tx + transfers[i].len);
+			message.CsChange.push_back(transfers[i].cs_change != 0);
+		}
+		SpidevMessages.push_back(message);
+	}
+	return 0;
+}
+
+// A committed frame of 4 displays is one ioctl, one transfer per digit, that the emulator decodes to the frame
+uint32_t CheckSpidevBatch(void)
+{
+	uint32_t failures = 0;
+	MAX7219_TransportSpidev spidev("/dev/null", 1000); // any node opens, ioctl is interposed
+	MAX7219_SS_RPI display(&spidev);
+	CHECK(InitEmulatedChain(display, 4));
+
+	display.SetFrameBuffered(true);
+	const char *texts[4] = {"dISPLAY1", "12345678", "-HELP-  ", "abcdefgh"};
+	for (uint8_t number = 1; number <= 4; number++)
+	{
+		display.SetCurrentDisplayNumber(number);
+		display.DisplayText(texts[number - 1], display.AlignLeft);
+	}
+	SpidevMessages.clear();
+	display.CommitFrame();
+
+	CHECK(SpidevMessages.size() == 1);
+	if (SpidevMessages.size() != 1) return failures;
+	const SpidevMessage_t &message = SpidevMessages[0];
+	CHECK(message.Transfers.size() == 8);
+	MAX7219_Emulator emulator(4);
+	for (size_t i = 0; i < message.Transfers.size(); i++)
+	{
+		CHECK(message.Transfers[i].size() == 8);
+		CHECK(message.CsChange[i] == (i + 1 < message.Transfers.size())); // last one ends the message
+		emulator.Transfer(message.Transfers[i].data(), message.Transfers[i].size());
+	}
+	for (uint8_t chip = 0; chip < 4; chip++)
+	{
+		for (uint8_t digit = 0; digit < 8; digit++)
+		{
+			CHECK(emulator.GetRegister(chip, digit + 1) == SevenSegFetch(texts[chip][7 - digit], 0));
+		}
+	}
+	return failures;
+}
+
+// Writes of one round of the parallel lanes check, differ per lane and round
+void DrawLaneTest(MAX7219_SS_RPI &display, uint8_t lane, uint8_t round)
+{
+	const uint8_t chainLength = display.GetChainLength();
+	for (uint8_t number = 1; number <= chainLength; number++)
+	{
+		display.SetCurrentDisplayNumber(number);
+		display.DisplayIntNum((lane + 1) * 1000000UL + number * 1000UL + round, display.AlignRight);
+		display.SetBrightness((lane + number + round) & 0x0F);
+	}
+	if (round == 1) display.SetBrightnessAll(lane + 3);
+}
+
+// Three chains of 2, 1 and 3 displays on one CLK and CS, each lane decoded from the GPIO
+// states matches a chain driven on its own transport, and at CommDelay 0 every CLK edge and
+// every write after a CLK fall is held by the port
+uint32_t CheckParallelLanes(void)
+{
+	uint32_t failures = 0;
+	const uint8_t clock = 11;
+	const uint8_t chipSelect = 8;
+	const uint8_t dataPins[3] = {5, 6, 13};
+	const uint8_t chainLengths[3] = {2, 1, 3};
+	MAX7219_GpioPortRecorder port;
+	MAX7219_ParallelSWSPI parallel(&port, clock, chipSelect, dataPins, 3);
+	CHECK(parallel.Begin());
+
+	std::vector<std::unique_ptr<MAX7219_SS_RPI>> lanes;
+	std::vector<std::unique_ptr<MAX7219_Emulator>> references;
+	std::vector<std::unique_ptr<MAX7219_SS_RPI>> referenceDisplays;
+	for (uint8_t lane = 0; lane < 3; lane++)
+	{
+		lanes.emplace_back(new MAX7219_SS_RPI(parallel.GetLane(lane)));
+		references.emplace_back(new MAX7219_Emulator(chainLengths[lane]));
+		referenceDisplays.emplace_back(new MAX7219_SS_RPI(references[lane].get()));
+		CHECK(InitEmulatedChain(*lanes[lane], chainLengths[lane]));
+		CHECK(InitEmulatedChain(*referenceDisplays[lane], chainLengths[lane]));
+	}
+	parallel.Flush();
+	for (uint8_t round = 0; round < 2; round++)
+	{
+		for (uint8_t lane = 0; lane < 3; lane++)
+		{
+			DrawLaneTest(*lanes[lane], lane, round);
+			DrawLaneTest(*referenceDisplays[lane], lane, round);
+		}
+		parallel.Flush();
+	}
+
+	for (uint8_t lane = 0; lane < 3; lane++)
+	{
+		MAX7219_Emulator decoded(chainLengths[lane]);
+		decoded.FeedGpioStates(port.GetStates(), clock, chipSelect, dataPins[lane]);
+		for (uint8_t chip = 0; chip < chainLengths[lane]; chip++)
+		{
+			for (uint8_t reg = 1; reg < MAX7219_NUM_REGISTERS; reg++)
+			{
+				CHECK(decoded.GetRegister(chip, reg) == references[lane]->GetRegister(chip, reg));
+			}
+		}
+	}
+
+	const std::vector<uint32_t> &states = port.GetStates();
+	const std::vector<size_t> &holds = port.GetHolds();
+	const uint32_t clkMask = 1u << clock;
+	size_t unheld = 0;
+	for (size_t index = 2; index < states.size(); index++)
+	{
+		const bool clockEdge = (states[index] ^ states[index - 1]) & clkMask;
+		const bool afterFall = (states[index - 2] & clkMask) && !(states[index - 1] & clkMask);
+		if ((clockEdge || afterFall) && !std::binary_search(holds.begin(), holds.end(), index)) unheld++;
+	}
+	CHECK(!holds.empty());
+	CHECK(unheld == 0);
+	return failures;
+}
+
+// Capture single writes, chain writes and frames of 3 displays, read the file back and replay it
+uint32_t CheckCaptureReplay(void)
+{
+	uint32_t failures = 0;
+	char path[] = "/tmp/max7219_checkXXXXXX";
+	const int fd = mkstemp(path);
+	CHECK(fd >= 0);
+	if (fd < 0) return failures;
+	close(fd);
+
+	MAX7219_TransportRecorder recorder;
+	MAX7219_SS_RPI display(&recorder);
+	CHECK(display.StartCapture(path));
+	CHECK(InitEmulatedChain(display, 3));
+	display.SetBrightnessAll(5);
+	display.SetCurrentDisplayNumber(2);
+	display.DisplayText("CAPtUrE", display.AlignRight);
+	display.DisplayTextWide("replay 1.2.3 of 3 displays", display.AlignLeft);
+	display.SetFrameBuffered(true);
+	display.SetCurrentDisplayNumber(3);
+	display.DisplayIntNum(20260501, display.AlignRight);
+	display.CommitFrame();
+	display.StopCapture();
+
+	MAX7219_CaptureReader reader;
+	CHECK(reader.Open(path));
+	MAX7219_Emulator replayed(3);
+	const std::vector<uint8_t> &sent = recorder.GetBytes();
+	const std::vector<uint16_t> &lengths = recorder.GetTransactionLengths();
+	uint8_t buffer[MAX7219_MAX_DISPLAYS * 2];
+	uint16_t length = 0;
+	uint32_t deltaUs = 0;
+	size_t transaction = 0;
+	size_t offset = 0;
+	while (reader.Next(buffer, sizeof(buffer), length, deltaUs))
+	{
+		CHECK(transaction < lengths.size());
+		if (transaction >= lengths.size()) break;
+		CHECK(length == lengths[transaction]);
+		CHECK(memcmp(buffer, sent.data() + offset, length) == 0);
+		replayed.Transfer(buffer, length);
+		offset += lengths[transaction++];
+	}
+	CHECK(lengths.size() > 0 && transaction == lengths.size());
+	reader.Close();
+	unlink(path);
+
+	MAX7219_Emulator original(3);
+	offset = 0;
+	for (uint16_t sentLength : lengths)
+	{
+		original.Transfer(sent.data() + offset, sentLength);
+		offset += sentLength;
+	}
+	for (uint8_t chip = 0; chip < 3; chip++)
+	{
+		for (uint8_t reg = 1; reg < MAX7219_NUM_REGISTERS; reg++)
+		{
+			CHECK(replayed.GetRegister(chip, reg) == original.GetRegister(chip, reg));
+		}
+	}
+	return failures;
+}
+
+// Two long lived tasks, then enough add/remove cycles to wrap the id counter twice
+uint32_t CheckSchedulerIds(void)
+{
+	uint32_t failures = 0;
+	MAX7219_Scheduler scheduler;
+	CHECK(scheduler.Begin());
+	const int16_t first = scheduler.AddTask(1000, []{ return true; });
+	const int16_t second = scheduler.AddTask(1000, []{ return true; });
+	CHECK(first >= 0 && second >= 0 && first != second);
+	uint32_t reused = 0;
+	for (uint32_t i = 0; i < 70000; i++)
+	{
+		const int16_t id = scheduler.AddTask(1000, []{ return true; });
+		if (id < 0 || id == first || id == second) reused++;
+		scheduler.RemoveTask(id);
+	}
+	CHECK(reused == 0);
+	CHECK(scheduler.GetTaskCount() == 2);
+	CHECK(scheduler.RemoveTask(first));
+	CHECK(!scheduler.RemoveTask(first));
+	CHECK(scheduler.GetTaskCount() == 1);
+	scheduler.End();
+	return failures;
+}
+
+// InitChain of 3 displays with per display settings
+uint32_t CheckInitChain(void)
+{
+	uint32_t failures = 0;
+	MAX7219_Emulator emulator(3);
+	MAX7219_SS_RPI display(&emulator);
+	MAX7219_SS_RPI::ChipConfig_t config[3] =
+	{
+		{display.ScanFourDigit, display.DecodeModeNone, 2},
+		{display.ScanEightDigit, display.DecodeModeBCDThree, 9},
+		{display.ScanFourDigit, display.DecodeModeBCDTwo, 15},
+	};
+	CHECK(!display.InitChain(3, config));
+	CHECK(emulator.GetLatchCount() == 0);
+
+	config[1].ScanLimit = display.ScanFourDigit;
+	CHECK(display.InitChain(3, config));
+	CHECK(display.GetNumDigits() == 4);
+	CHECK(display.GetWideWidth() == 12);
+	for (uint8_t chip = 0; chip < 3; chip++)
+	{
+		CHECK(emulator.GetRegister(chip, display.MAX7219_REG_ScanLimit) == display.ScanFourDigit);
+		CHECK(emulator.GetRegister(chip, display.MAX7219_REG_DecodeMode) == config[chip].DecodeMode);
+		CHECK(emulator.GetRegister(chip, display.MAX7219_REG_Intensity) == config[chip].Intensity);
+		CHECK(emulator.GetRegister(chip, display.MAX7219_REG_ShutDown) == 1);
+		for (uint8_t digit = 0; digit < 8; digit++) CHECK(emulator.GetSegments(chip, digit) == 0);
+	}
+	return failures;
+}
+
+// Cached wide frames from the caller thread while the render thread owns the bus and shadow registers
+uint32_t CheckFrameCacheAsync(void)
+{
+	uint32_t failures = 0;
+	// every text fills the 16 digits, only full frames are cached
+	const char *texts[3] = {"12:00:00 HELLO  ", "-3.14159265358 PI", "CACHE ASYNC 2024"};
+	MAX7219_Emulator reference(2);
+	MAX7219_SS_RPI referenceDisplay(&reference);
+	CHECK(InitEmulatedChain(referenceDisplay, 2));
+	referenceDisplay.DisplayTextWide(texts[2], referenceDisplay.AlignLeft);
+
+	for (uint8_t latest = 0; latest < 2; latest++)
+	{
+		MAX7219_Emulator emulator(2);
+		MAX7219_SS_RPI display(&emulator);
+		CHECK(InitEmulatedChain(display, 2));
+		display.SetFrameCache(4);
+		display.DisplayTextWide(texts[1], display.AlignLeft); // shadow path, before the thread
+		CHECK(latest ? display.StartAsyncLatest(0) : display.StartAsync(1024));
+		for (uint16_t round = 0; round < 300; round++)
+			display.DisplayTextWide(texts[round % 3], display.AlignLeft);
+		MAX7219_SS_RPI::AsyncStats_t asyncStats;
+		display.GetAsyncStats(asyncStats);
+		display.StopAsync();
+		CHECK(asyncStats.FramesDropped == 0);
+
+		MAX7219_FrameCache::Stats_t cacheStats;
+		display.GetFrameCacheStats(cacheStats);
+		CHECK(cacheStats.Hits >= 297);
+		for (uint8_t chip = 0; chip < 2; chip++)
+			for (uint8_t digit = 0; digit < 8; digit++)
+				CHECK(emulator.GetSegments(chip, digit) == reference.GetSegments(chip, digit));
+
+		// back on the caller thread, the shadow registers follow the frames the thread sent
+		display.DisplayTextWide(texts[0], display.AlignLeft);
+		referenceDisplay.DisplayTextWide(texts[0], referenceDisplay.AlignLeft);
+		for (uint8_t chip = 0; chip < 2; chip++)
+			for (uint8_t digit = 0; digit < 8; digit++)
+				CHECK(emulator.GetSegments(chip, digit) == reference.GetSegments(chip, digit));
+		referenceDisplay.DisplayTextWide(texts[2], referenceDisplay.AlignLeft);
+	}
+	return failures;
+}
+
+// Two keys forced onto one hash are told apart by their bytes
+uint32_t CheckFrameCacheCollisions(void)
+{
+	uint32_t failures = 0;
+	const uint64_t hash = MAX7219_FrameCache::Hash("AB", 2);
+	MAX7219_FrameCache cache(4, 8, 16);
+	int32_t index = cache.Insert(hash, "AB", 2);
+	CHECK(index >= 0);
+	if (index >= 0) memset(cache.GetEntry(index), 'A', 8);
+
+	CHECK(cache.Find(hash, "CD", 2) == -1);
+	CHECK(cache.Find(hash, "ABC", 3) == -1);
+	index = cache.Insert(hash, "CD", 2);
+	CHECK(index >= 0);
+	if (index >= 0) memset(cache.GetEntry(index), 'C', 8);
+
+	index = cache.Find(hash, "AB", 2);
+	CHECK(index >= 0 && cache.GetEntry(index)[0] == 'A');
+	index = cache.Find(hash, "CD", 2);
+	CHECK(index >= 0 && cache.GetEntry(index)[0] == 'C');
+	CHECK(cache.Insert(hash, "0123456789ABCDEFG", 17) == -1); // longer than keySize
+
+	MAX7219_FrameCache::Stats_t stats;
+	cache.GetStats(stats);
+	CHECK(stats.Hits == 2);
+	CHECK(stats.Misses == 2);
+	CHECK(stats.Collisions == 3); // AB entry passed by the two misses, CD entry by the AB lookup
+	CHECK(stats.Entries == 2);
+	return failures;
+}
+
+// DisplayIntNum and DisplayDecNumNibble against the snprintf formats of version 1.4
+uint32_t CheckNumberFormat(void)
+{
+	uint32_t failures = 0;
+	const MAX7219_SS_RPI::TextAlignment_e alignments[3] =
+		{MAX7219_SS_RPI::AlignLeft, MAX7219_SS_RPI::AlignRight, MAX7219_SS_RPI::AlignRightZeros};
+	const unsigned long numbers[] = {0, 7, 42, 905, 1000, 31415, 270000, 9999999, 12345678, 123456789, 4000000000UL};
+	const uint16_t nibbles[] = {0, 3, 58, 407, 9999, 12345};
+	MAX7219_Emulator emulator(1);
+	MAX7219_Emulator reference(1);
+	MAX7219_SS_RPI display(&emulator);
+	MAX7219_SS_RPI referenceDisplay(&reference);
+	CHECK(display.InitDisplay(display.ScanEightDigit, display.DecodeModeNone));
+	CHECK(referenceDisplay.InitDisplay(referenceDisplay.ScanEightDigit, referenceDisplay.DecodeModeNone));
+
+	uint32_t mismatches = 0;
+	for (const MAX7219_SS_RPI::TextAlignment_e alignment : alignments)
+	{
+		for (const unsigned long number : numbers)
+		{
+			display.DisplayIntNum(number, alignment);
+			SnprintfIntNum(referenceDisplay, number, alignment);
+			for (uint8_t digit = 0; digit < 8; digit++)
+				if (emulator.GetSegments(0, digit) != reference.GetSegments(0, digit)) mismatches++;
+		}
+		for (const uint16_t upper : nibbles)
+		{
+			for (const uint16_t lower : nibbles)
+			{
+				display.DisplayDecNumNibble(upper, lower, alignment);
+				SnprintfDecNumNibble(referenceDisplay, upper, lower, alignment);
+				for (uint8_t digit = 0; digit < 8; digit++)
+					if (emulator.GetSegments(0, digit) != reference.GetSegments(0, digit)) mismatches++;
+			}
+		}
+	}
+	CHECK(mismatches == 0);
+
+	// decimal point past the digits of the number, 0.000000 kept from 0.00...05
+	const uint8_t zero = SevenSegFetch('0', 0);
+	const uint8_t zeroPoint = SevenSegFetch('0', 1);
+	display.DisplayFixedNum(5, 30, display.AlignLeft);
+	CHECK(emulator.GetSegments(0, 7) == zeroPoint);
+	for (uint8_t digit = 0; digit < 7; digit++) CHECK(emulator.GetSegments(0, digit) == zero);
+	display.DisplayFixedNum(-5, 255, display.AlignRight);
+	CHECK(emulator.GetSegments(0, 7) == SevenSegFetch('-', 0));
+	CHECK(emulator.GetSegments(0, 6) == zeroPoint);
+
+	// four digits scanned, right alignment pads to four
+	MAX7219_Emulator small(1);
+	MAX7219_SS_RPI smallDisplay(&small);
+	CHECK(smallDisplay.InitDisplay(smallDisplay.ScanFourDigit, smallDisplay.DecodeModeNone));
+	smallDisplay.DisplayIntNum(12, smallDisplay.AlignRight);
+	CHECK(small.GetSegments(0, 3) == SevenSegFetch(' ', 0));
+	CHECK(small.GetSegments(0, 2) == SevenSegFetch(' ', 0));
+	CHECK(small.GetSegments(0, 1) == SevenSegFetch('1', 0));
+	CHECK(small.GetSegments(0, 0) == SevenSegFetch('2', 0));
+	smallDisplay.DisplayIntNum(7, smallDisplay.AlignRightZeros);
+	CHECK(small.GetSegments(0, 3) == zero && small.GetSegments(0, 1) == zero);
+	CHECK(small.GetSegments(0, 0) == SevenSegFetch('7', 0));
+	return failures;
+}
+
+// Shadow register users on the caller thread while the render thread flushes frames
+uint32_t CheckAsyncShadow(void)
+{
+	uint32_t failures = 0;
+	const char *texts[2] = {"AB12CD34EF56HI78", "0123456789ABCDEF"};
+	MAX7219_Emulator emulator(2);
+	MAX7219_SS_RPI display(&emulator);
+	CHECK(InitEmulatedChain(display, 2));
+	CHECK(display.StartAsync(8192));
+	CHECK(!display.InitDisplay(display.ScanEightDigit, display.DecodeModeNone));
+	CHECK(!display.InitChain(2, nullptr));
+	for (uint16_t round = 0; round < 4000; round++)
+	{
+		display.DisplayTextWide(texts[round % 2], display.AlignLeft);
+		if (round % 3 == 0) display.InvalidateShadow(); // right after a commit, the thread is flushing
+		if (round % 5 == 0) display.RefreshDisplay();
+		if (round % 13 == 0) display.SetBrightness(round % 16);
+	}
+	display.SetBrightness(5);
+	MAX7219_SS_RPI::AsyncStats_t asyncStats;
+	display.GetAsyncStats(asyncStats);
+	display.StopAsync();
+	CHECK(asyncStats.FramesDropped == 0);
+	for (uint8_t chip = 0; chip < 2; chip++)
+	{
+		for (uint8_t digit = 0; digit < 8; digit++)
+			CHECK(emulator.GetSegments(chip, digit) == SevenSegFetch(texts[1][(chip * 8) + 7 - digit], 0));
+	}
+	CHECK(emulator.GetRegister(0, display.MAX7219_REG_Intensity) == 5);
+
+	// the shadow still follows the displays, a refresh resends them as they are
+	display.RefreshDisplay();
+	for (uint8_t digit = 0; digit < 8; digit++)
+		CHECK(emulator.GetSegments(1, digit) == SevenSegFetch(texts[1][8 + 7 - digit], 0));
+	CHECK(display.InitDisplay(display.ScanEightDigit, display.DecodeModeNone));
+	return failures;
+}
+
+// Latest wins mailbox at 50 frames a second fed a frame a millisecond
+uint32_t CheckLatestWins(void)
+{
+	uint32_t failures = 0;
+	MAX7219_Emulator emulator(1);
+	MAX7219_SS_RPI display(&emulator);
+	CHECK(InitEmulatedChain(display, 1));
+	const auto start = std::chrono::steady_clock::now();
+	CHECK(display.StartAsyncLatest(50));
+	CHECK(!display.StartAsync(16)); // already running
+	for (unsigned long number = 1; number <= 200; number++)
+	{
+		display.DisplayIntNumWide(number, display.AlignRight);
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+	std::this_thread::sleep_for(std::chrono::milliseconds(60));
+	for (uint8_t repeat = 0; repeat < 10; repeat++)
+		display.DisplayIntNumWide(200, display.AlignRight);
+	display.StopAsync();
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	MAX7219_SS_RPI::AsyncStats_t stats;
+	display.GetAsyncStats(stats);
+	CHECK(stats.FramesQueued == 200);
+	CHECK(stats.FramesUnchanged == 10);
+	CHECK(stats.FramesDropped == 0);
+	CHECK(stats.FramesFlushed + stats.FramesCoalesced == stats.FramesQueued);
+	CHECK(stats.FramesFlushed >= 2);
+	CHECK(stats.FramesCoalesced > 0);
+	CHECK(stats.FramesFlushed <= (uint32_t)(seconds * 50) + 2); // rate limit, plus the frame drained by StopAsync
+	CHECK(stats.QueueCapacity == 1 && stats.QueueDepth == 0);
+	for (uint8_t digit = 0; digit < 8; digit++)
+		CHECK(emulator.GetSegments(0, digit) == SevenSegFetch("     200"[7 - digit], 0));
+	return failures;
+}
+
+// Writes to one display of a chain of 3, recorded and emulated
+uint32_t CheckCascadePadding(void)
+{
+	uint32_t failures = 0;
+	MAX7219_TransportRecorder recorder;
+	MAX7219_SS_RPI recorded(&recorder);
+	CHECK(InitEmulatedChain(recorded, 3));
+	for (uint8_t number = 1; number <= 3; number++)
+	{
+		recorder.Clear();
+		recorded.SetCurrentDisplayNumber(number);
+		recorded.SetBrightness(number);
+		CHECK(recorder.GetTransactionCount() == 1);
+		CHECK(recorder.GetByteCount() == 6);
+		if (recorder.GetByteCount() != 6) continue;
+		const uint8_t slot = (3 - number) * 2; // first pair lands in display 3
+		for (uint8_t index = 0; index < 6; index += 2)
+		{
+			const std::vector<uint8_t> &bytes = recorder.GetBytes();
+			if (index == slot) CHECK(bytes[index] == recorded.MAX7219_REG_Intensity && bytes[index + 1] == number);
+			else CHECK(bytes[index] == recorded.MAX7219_REG_NOP && bytes[index + 1] == 0);
+		}
+	}
+
+	MAX7219_Emulator emulator(3);
+	MAX7219_SS_RPI display(&emulator);
+	CHECK(InitEmulatedChain(display, 3));
+	const char *texts[3] = {"11111111", "22222222", "33333333"};
+	for (uint8_t number = 3; number >= 1; number--)
+	{
+		display.SetCurrentDisplayNumber(number);
+		display.DisplayText(texts[number - 1]);
+	}
+	display.SetCurrentDisplayNumber(1);
+	display.DisplayText("AbCdEF12");
+	display.SetBrightness(2);
+	for (uint8_t digit = 0; digit < 8; digit++)
+	{
+		CHECK(emulator.GetSegments(0, digit) == SevenSegFetch("AbCdEF12"[7 - digit], 0));
+		CHECK(emulator.GetSegments(1, digit) == SevenSegFetch('2', 0));
+		CHECK(emulator.GetSegments(2, digit) == SevenSegFetch('3', 0));
+	}
+	CHECK(emulator.GetRegister(0, display.MAX7219_REG_Intensity) == 2);
+	CHECK(emulator.GetRegister(1, display.MAX7219_REG_Intensity) == display.IntensityDefault);
+	CHECK(emulator.GetRegister(2, display.MAX7219_REG_Intensity) == display.IntensityDefault);
+	return failures;
+}
+
+// Single writes and frames to a chain of 3, each display counts its pair of every transaction
+uint32_t CheckChipStats(void)
+{
+	uint32_t failures = 0;
+	MAX7219_TransportRecorder recorder;
+	MAX7219_SS_RPI display(&recorder);
+	CHECK(InitEmulatedChain(display, 3));
+	display.ResetStats();
+	recorder.Clear();
+	display.SetCurrentDisplayNumber(2);
+	display.SetBrightness(5);
+	display.SetFrameBuffered(true);
+	for (uint8_t number = 1; number <= 3; number++)
+	{
+		display.SetCurrentDisplayNumber(number);
+		display.DisplayIntNum(number * 1111, display.AlignRight);
+	}
+	display.CommitFrame();
+
+	MAX7219_SS_RPI::Stats_t stats;
+	display.GetStats(stats);
+	CHECK(stats.Transactions == recorder.GetTransactionCount());
+	CHECK(stats.BytesSent == recorder.GetByteCount());
+	uint64_t bytesSent = 0;
+	uint64_t transportNs = 0;
+	for (uint8_t number = 1; number <= 3; number++)
+	{
+		MAX7219_SS_RPI::ChipStats_t chipStats;
+		display.GetChipStats(number, chipStats);
+		CHECK(chipStats.Transactions == stats.Transactions);
+		CHECK(chipStats.BytesSent == stats.Transactions * 2);
+		CHECK(chipStats.TransportNs <= stats.TransportNs);
+		bytesSent += chipStats.BytesSent;
+		transportNs += chipStats.TransportNs;
+	}
+	CHECK(bytesSent == stats.BytesSent);
+	CHECK(transportNs <= stats.TransportNs && transportNs >= stats.TransportNs / 2);
+
+	MAX7219_SS_RPI::ChipStats_t outside;
+	display.GetChipStats(4, outside);
+	CHECK(outside.Transactions == 0 && outside.BytesSent == 0 && outside.TransportNs == 0);
+
+	return failures;
+}
+
+// Frame after InvalidateShadow to a chain of 2 displays scanning 4 digits, recorded
+uint32_t CheckFrameScanLimit(void)
+{
+	uint32_t failures = 0;
+	MAX7219_TransportRecorder recorder;
+	MAX7219_SS_RPI display(&recorder);
+	for (uint8_t number = 2; number >= 1; number--)
+	{
+		display.SetCurrentDisplayNumber(number);
+		CHECK(display.InitDisplay(display.ScanFourDigit, display.DecodeModeNone));
+	}
+	CHECK(display.GetNumDigits() == 4);
+	display.SetFrameBuffered(true);
+	display.InvalidateShadow(); // every digit dirty, including 5-8 past the scan limit
+	recorder.Clear();
+	display.SetCurrentDisplayNumber(1);
+	display.DisplayText("1234");
+	display.SetCurrentDisplayNumber(2);
+	display.DisplayText("5678");
+	display.CommitFrame();
+
+	CHECK(recorder.GetTransactionCount() == 4);
+	CHECK(recorder.GetByteCount() == 4 * 4);
+	const std::vector<uint8_t> &bytes = recorder.GetBytes();
+	for (size_t index = 0; index < bytes.size(); index += 2)
+	{
+		CHECK(bytes[index] >= 1 && bytes[index] <= 4); // digit registers 1-4 only
+	}
+	return failures;
+}
+
+// Cache entries found through the hash index, and the wide writes that look them up
+uint32_t CheckFrameCacheLookups(void)
+{
+	uint32_t failures = 0;
+	MAX7219_FrameCache cache(8, 4, 8);
+	char key[8];
+	uint32_t found = 0;
+	for (uint8_t round = 0; round < 40; round++)
+	{
+		const int length = snprintf(key, sizeof(key), "key%u", round);
+		const int32_t index = cache.Insert(MAX7219_FrameCache::Hash(key, length), key, length);
+		CHECK(index >= 0);
+		if (index >= 0) memset(cache.GetEntry(index), round, 4);
+	}
+	for (uint8_t round = 0; round < 40; round++)
+	{
+		const int length = snprintf(key, sizeof(key), "key%u", round);
+		const int32_t index = cache.Find(MAX7219_FrameCache::Hash(key, length), key, length);
+		if (round < 32) CHECK(index == -1); // evicted
+		else if (index >= 0 && cache.GetEntry(index)[0] == round) found++;
+	}
+	CHECK(found == 8);
+	cache.Clear();
+	CHECK(cache.Find(MAX7219_FrameCache::Hash("key39", 5), "key39", 5) == -1);
+	MAX7219_FrameCache::Stats_t cacheStats;
+	cache.GetStats(cacheStats);
+	CHECK(cacheStats.Evictions == 32 && cacheStats.Hits == 8 && cacheStats.Misses == 33);
+
+	MAX7219_Emulator emulators[2] = {MAX7219_Emulator(2), MAX7219_Emulator(2)}; // cached, reference
+	for (uint8_t cached = 0; cached < 2; cached++)
+	{
+		MAX7219_SS_RPI display(&emulators[cached]);
+		CHECK(InitEmulatedChain(display, 2));
+		if (cached) display.SetFrameCache(4);
+		display.DisplayTextWide("0123456789ABCDEF", display.AlignLeft);
+		display.DisplayTextWide("0123456789ABCDEF", display.AlignLeft);
+		display.DisplayIntNumWide(42, display.AlignRight);
+		display.DisplayIntNumWide(42, display.AlignRight);
+		display.GetFrameCacheStats(cacheStats);
+		if (cached) CHECK(cacheStats.Hits == 2 && cacheStats.Misses == 2 && cacheStats.Entries == 2);
+
+		// none of these covers the 16 digits, they keep the digits they do not write
+		display.DisplayTextWide("HELLO", display.AlignLeft);
+		display.DisplayTextWide("HELLO", display.AlignLeft);
+		display.DisplayTextWide("H.E.L.L.O.H.E.L.L.O.", display.AlignRight); // 20 characters, 10 digits
+		display.DisplayIntNumWide(42, display.AlignLeft);
+		display.DisplayFixedNumWide(-15, 1, display.AlignLeft);
+		display.GetFrameCacheStats(cacheStats);
+		if (cached) CHECK(cacheStats.Hits == 2 && cacheStats.Misses == 2 && cacheStats.Entries == 2);
+	}
+	for (uint8_t chip = 0; chip < 2; chip++)
+		for (uint8_t digit = 0; digit < 8; digit++)
+			CHECK(emulators[1].GetSegments(chip, digit) == emulators[0].GetSegments(chip, digit));
+	return failures;
+}
+
+// DisplayIntNum of version 1.4, snprintf then DisplayText
+void SnprintfIntNum(MAX7219_SS_RPI &display, unsigned long number, MAX7219_SS_RPI::TextAlignment_e alignment)
+{
+	const char *format = (alignment == MAX7219_SS_RPI::AlignRight) ? "%8ld" :
+		(alignment == MAX7219_SS_RPI::AlignLeft) ? "%ld" : "%08ld";
+	char values[MAX7219_NUM_DIGITS + 1];
+	snprintf(values, display.GetNumDigits() + 1, format, number);
+	display.DisplayText(values);
+}
+
+// DisplayDecNumNibble of version 1.4, two snprintf then DisplayText
+void SnprintfDecNumNibble(MAX7219_SS_RPI &display, uint16_t numberUpper, uint16_t numberLower,
+	MAX7219_SS_RPI::TextAlignment_e alignment)
+{
+	const char *format = (alignment == MAX7219_SS_RPI::AlignRight) ? "%4d" :
+		(alignment == MAX7219_SS_RPI::AlignLeft) ? "%-4d" : "%04d";
+	char valuesUpper[MAX7219_NUM_DIGITS + 1];
+	char valuesLower[MAX7219_NUM_DIGITS / 2 + 1];
+	snprintf(valuesUpper, display.GetNumDigits() / 2 + 1, format, numberUpper);
+	snprintf(valuesLower, display.GetNumDigits() / 2 + 1, format, numberLower);
+	strcat(valuesUpper, valuesLower);
+	display.DisplayText(valuesUpper);
+}
+// EOF
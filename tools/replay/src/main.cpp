@@ -0,0 +1,171 @@
+/*!
+	@file MAX7219_7SEG_RPI/tools/replay/src/main.cpp
+	@author Gavin Lyons
+	@brief Replays a capture file made by MAX7219_SS_RPI::StartCapture through any transport
+	at the original speed or as fast as the transport allows, then prints a summary.
+
+	Project Name: MAX7219_7SEG_RPI
+
+	@note Usage: ./bin/replay [-m] [-l loops] [-t transport] capture-file
+		-m  maximum speed, ignore capture time stamps
+		-l  number of times to replay the file, default 1
+		-t  transport, default recorder:
+			recorder                      count only, no hardware
+			spidev:/dev/spidev0.0[:kHz]   Linux spidev
+			hwspi:CE[:kHz]                SPI0, CE 0 or 1 (bcm2835 builds only)
+			auxspi[:kHz]                  SPI1 (bcm2835 builds only)
+			swspi:CLK,CS,DIN              software SPI GPIO (bcm2835 builds only)
+*/
+
+// Libraries
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <memory>
+#include <MAX7219_7SEG_RPI.hpp>
+#include <MAX7219_7SEG_RPI_Capture.hpp>
+#include <MAX7219_7SEG_RPI_Scheduler.hpp>
+
+// Function Prototypes
+MAX7219_Transport* MakeTransport(const char *spec);
+void Usage(const char *name);
+
+bool BCM2835Used = false; // true if bcm2835_init was called
+
+// Main loop
+int main(int argc, char **argv)
+{
+	bool maxSpeed = false;
+	uint32_t loops = 1;
+	const char *transportSpec = "recorder";
+	const char *path = nullptr;
+	for (int arg = 1; arg < argc; arg++)
+	{
+		if (strcmp(argv[arg], "-m") == 0) maxSpeed = true;
+		else if (strcmp(argv[arg], "-l") == 0 && arg + 1 < argc) loops = strtoul(argv[++arg], nullptr, 10);
+		else if (strcmp(argv[arg], "-t") == 0 && arg + 1 < argc) transportSpec = argv[++arg];
+		else if (argv[arg][0] != '-' && path == nullptr) path = argv[arg];
+		else
+		{
+			Usage(argv[0]);
+			return -1;
+		}
+	}
+	if (path == nullptr)
+	{
+		Usage(argv[0]);
+		return -1;
+	}
+
+	std::unique_ptr<MAX7219_Transport> transport(MakeTransport(transportSpec));
+	if (!transport)
+	{
+		fprintf(stderr, "Error :: unknown transport %s\n", transportSpec);
+		return -1;
+	}
+	if (!transport->Begin())
+	{
+		fprintf(stderr, "Error :: transport %s failed to begin\n", transportSpec);
+		return -1;
+	}
+
+	uint8_t buffer[MAX7219_MAX_DISPLAYS * 2 * 8];
+	uint16_t length = 0;
+	uint32_t deltaUs = 0;
+	uint64_t transactions = 0;
+	uint64_t bytes = 0;
+	uint64_t captureUs = 0;
+	const int64_t startNs = MAX7219_Scheduler::NowNs();
+	int64_t deadlineNs = startNs;
+
+	for (uint32_t loop = 0; loop < loops; loop++)
+	{
+		MAX7219_CaptureReader reader;
+		if (!reader.Open(path))
+		{
+			fprintf(stderr, "Error :: %s is not a capture file\n", path);
+			return -1;
+		}
+		while (reader.Next(buffer, sizeof(buffer), length, deltaUs))
+		{
+			captureUs += deltaUs;
+			if (!maxSpeed)
+			{
+				deadlineNs += (int64_t)deltaUs * 1000;
+				MAX7219_Scheduler::SleepUntilNs(deadlineNs);
+			}
+			transport->Transfer(buffer, length);
+			transactions++;
+			bytes += length;
+		}
+	}
+	const int64_t elapsedNs = MAX7219_Scheduler::NowNs() - startNs;
+	transport->End();
+#ifndef MAX7219_NO_BCM2835
+	if (BCM2835Used) bcm2835_close();
+#endif
+
+	printf("transactions,bytes,capture_us,replay_us,transactions_per_second\n");
+	printf("%llu,%llu,%llu,%lld,%.0f\n", (unsigned long long)transactions, (unsigned long long)bytes,
+		(unsigned long long)captureUs, (long long)(elapsedNs / 1000),
+		(elapsedNs > 0) ? transactions * 1e9 / elapsedNs : 0.0);
+	return 0;
+}
+// End of main
+
+// Function Space
+
+// Create the transport named on the command line, nullptr if unknown
+MAX7219_Transport* MakeTransport(const char *spec)
+{
+	if (strcmp(spec, "recorder") == 0) return new MAX7219_TransportRecorder(false);
+	if (strncmp(spec, "spidev:", 7) == 0)
+	{
+		char device[32] = {};
+		strncpy(device, spec + 7, sizeof(device) - 1);
+		uint32_t kiloHertz = 5000;
+		char *speed = strchr(device, ':');
+		if (speed != nullptr)
+		{
+			*speed = '\0';
+			kiloHertz = strtoul(speed + 1, nullptr, 10);
+		}
+		return new MAX7219_TransportSpidev(device, kiloHertz);
+	}
+#ifndef MAX7219_NO_BCM2835
+	if (strncmp(spec, "hwspi:", 6) == 0 || strncmp(spec, "auxspi", 6) == 0 || strncmp(spec, "swspi:", 6) == 0)
+	{
+		if (!bcm2835_init())
+		{
+			fprintf(stderr, "Error :: bcm2835_init failed. Are you running as root??\n");
+			return nullptr;
+		}
+		BCM2835Used = true;
+	}
+	if (strncmp(spec, "hwspi:", 6) == 0)
+	{
+		char *speed = nullptr;
+		const uint8_t chipEnable = strtoul(spec + 6, &speed, 10);
+		const uint32_t kiloHertz = (speed != nullptr && *speed == ':') ? strtoul(speed + 1, nullptr, 10) : 5000;
+		return new MAX7219_TransportHWSPI(kiloHertz, chipEnable);
+	}
+	if (strncmp(spec, "auxspi", 6) == 0)
+	{
+		const uint32_t kiloHertz = (spec[6] == ':') ? strtoul(spec + 7, nullptr, 10) : 5000;
+		return new MAX7219_TransportAuxSPI(kiloHertz);
+	}
+	if (strncmp(spec, "swspi:", 6) == 0)
+	{
+		unsigned clock, chipSelect, data;
+		if (sscanf(spec + 6, "%u,%u,%u", &clock, &chipSelect, &data) != 3) return nullptr;
+		return new MAX7219_TransportSWSPI(clock, chipSelect, data);
+	}
+#endif
+	return nullptr;
+}
+
+void Usage(const char *name)
+{
+	fprintf(stderr, "Usage: %s [-m] [-l loops] [-t recorder|spidev:DEV[:kHz]|hwspi:CE[:kHz]|auxspi[:kHz]|swspi:CLK,CS,DIN] capture-file\n", name);
+}
+// EOF